@@ -28,6 +28,8 @@ Sink& DspInterface::GetSink() {
 }
 
 void DspInterface::OutputFrame(StereoFrame16& frame) {
+    Core::System::GetInstance().frame_dumper.AddAudioSamples(frame[0].data(), frame.size());
+
     if (!sink) {
         return;
     }
@@ -36,6 +38,8 @@ void DspInterface::OutputFrame(StereoFrame16& frame) {
 }
 
 void DspInterface::OutputSample(std::array<s16, 2> sample) {
+    Core::System::GetInstance().frame_dumper.AddAudioSamples(sample.data(), 1);
+
     if (!sink) {
         return;
     }
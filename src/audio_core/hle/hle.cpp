@@ -19,6 +19,7 @@
 #include "common/common_types.h"
 #include "common/hash.h"
 #include "common/logging/log.h"
+#include "common/profiler.h"
 #include "core/core.h"
 #include "core/core_timing.h"
 #include "core/settings.h"
@@ -386,6 +387,8 @@ StereoFrame16 DspHle::Impl::GenerateCurrentFrame() {
 }
 
 bool DspHle::Impl::Tick() {
+    Common::Profiler::ScopedTimer timer{"Audio", "DSP Tick"};
+
     StereoFrame16 current_frame = {};
 
     // TODO: Check dsp::DSP semaphore (which indicates emulated application has finished writing to
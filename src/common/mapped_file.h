@@ -0,0 +1,37 @@
+// Copyright 2020 vvctre project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include "common/common_types.h"
+
+namespace Common {
+
+/// A read-only view of a whole file. The file is memory-mapped where the platform supports it, and
+/// read into memory otherwise.
+class MappedFile final {
+public:
+    MappedFile();
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /// Returns false if the file couldn't be opened or is empty
+    bool Open(const std::string& path);
+    void Close();
+
+    bool IsOpen() const;
+    const u8* GetData() const;
+    std::size_t GetSize() const;
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl;
+};
+
+} // namespace Common
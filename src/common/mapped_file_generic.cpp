@@ -0,0 +1,52 @@
+// Copyright 2020 vvctre project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <vector>
+#include "common/file_util.h"
+#include "common/mapped_file.h"
+
+namespace Common {
+
+struct MappedFile::Impl {
+    std::vector<u8> data;
+};
+
+MappedFile::MappedFile() : impl(std::make_unique<Impl>()) {}
+
+MappedFile::~MappedFile() = default;
+
+bool MappedFile::Open(const std::string& path) {
+    Close();
+
+    FileUtil::IOFile file(path, "rb");
+    if (!file.IsOpen() || file.GetSize() == 0) {
+        return false;
+    }
+
+    impl->data.resize(file.GetSize());
+    if (file.ReadBytes(impl->data.data(), impl->data.size()) != impl->data.size()) {
+        impl->data.clear();
+        return false;
+    }
+    return true;
+}
+
+void MappedFile::Close() {
+    impl->data.clear();
+    impl->data.shrink_to_fit();
+}
+
+bool MappedFile::IsOpen() const {
+    return !impl->data.empty();
+}
+
+const u8* MappedFile::GetData() const {
+    return impl->data.data();
+}
+
+std::size_t MappedFile::GetSize() const {
+    return impl->data.size();
+}
+
+} // namespace Common
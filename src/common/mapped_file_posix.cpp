@@ -0,0 +1,72 @@
+// Copyright 2020 vvctre project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "common/mapped_file.h"
+
+namespace Common {
+
+struct MappedFile::Impl {
+    u8* data = nullptr;
+    std::size_t size = 0;
+};
+
+MappedFile::MappedFile() : impl(std::make_unique<Impl>()) {}
+
+MappedFile::~MappedFile() {
+    Close();
+}
+
+bool MappedFile::Open(const std::string& path) {
+    Close();
+
+    const int fd = open(path.c_str(), O_RDONLY);
+    if (fd == -1) {
+        return false;
+    }
+
+    struct stat file_stat;
+    if (fstat(fd, &file_stat) != 0 || file_stat.st_size == 0) {
+        close(fd);
+        return false;
+    }
+
+    const std::size_t size = static_cast<std::size_t>(file_stat.st_size);
+    void* data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+        return false;
+    }
+
+    impl->data = static_cast<u8*>(data);
+    impl->size = size;
+    return true;
+}
+
+void MappedFile::Close() {
+    if (impl->data == nullptr) {
+        return;
+    }
+
+    munmap(impl->data, impl->size);
+    impl->data = nullptr;
+    impl->size = 0;
+}
+
+bool MappedFile::IsOpen() const {
+    return impl->data != nullptr;
+}
+
+const u8* MappedFile::GetData() const {
+    return impl->data;
+}
+
+std::size_t MappedFile::GetSize() const {
+    return impl->size;
+}
+
+} // namespace Common
@@ -0,0 +1,78 @@
+// Copyright 2020 vvctre project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <windows.h>
+#include "common/mapped_file.h"
+#include "common/string_util.h"
+
+namespace Common {
+
+struct MappedFile::Impl {
+    u8* data = nullptr;
+    std::size_t size = 0;
+};
+
+MappedFile::MappedFile() : impl(std::make_unique<Impl>()) {}
+
+MappedFile::~MappedFile() {
+    Close();
+}
+
+bool MappedFile::Open(const std::string& path) {
+    Close();
+
+    const HANDLE file =
+        CreateFileW(UTF8ToUTF16W(path).c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                    OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+
+    LARGE_INTEGER file_size;
+    if (!GetFileSizeEx(file, &file_size) || file_size.QuadPart == 0) {
+        CloseHandle(file);
+        return false;
+    }
+
+    const HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file);
+    if (mapping == nullptr) {
+        return false;
+    }
+
+    // The view keeps the mapping alive
+    void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mapping);
+    if (data == nullptr) {
+        return false;
+    }
+
+    impl->data = static_cast<u8*>(data);
+    impl->size = static_cast<std::size_t>(file_size.QuadPart);
+    return true;
+}
+
+void MappedFile::Close() {
+    if (impl->data == nullptr) {
+        return;
+    }
+
+    UnmapViewOfFile(impl->data);
+    impl->data = nullptr;
+    impl->size = 0;
+}
+
+bool MappedFile::IsOpen() const {
+    return impl->data != nullptr;
+}
+
+const u8* MappedFile::GetData() const {
+    return impl->data;
+}
+
+std::size_t MappedFile::GetSize() const {
+    return impl->size;
+}
+
+} // namespace Common
@@ -0,0 +1,201 @@
+// Copyright 2020 vvctre project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <utility>
+#include <fmt/format.h>
+#include "common/file_util.h"
+#include "common/logging/log.h"
+#include "common/profiler.h"
+
+namespace Common::Profiler {
+
+std::atomic<bool> g_enabled{false};
+
+namespace {
+
+/// Scopes a thread can record between two frames before the oldest ones are dropped
+constexpr std::size_t BUFFER_SIZE = 1 << 16;
+
+/// Traces stop growing after this many scopes
+constexpr std::size_t MAX_TRACE_EVENTS = 1 << 24;
+
+/// Single producer, single consumer ring buffer of the scopes recorded by a thread
+struct ThreadBuffer {
+    std::array<Event, BUFFER_SIZE> events;
+    std::atomic<u64> write_index{0};
+    u64 read_index = 0; ///< Only used by EndFrame
+    u32 thread = 0;
+};
+
+const std::chrono::steady_clock::time_point origin = std::chrono::steady_clock::now();
+
+std::mutex buffers_mutex;
+std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+thread_local ThreadBuffer* thread_buffer = nullptr;
+
+std::mutex stats_mutex;
+std::vector<ScopeStats> frame_stats;
+
+std::atomic<bool> tracing{false};
+std::vector<Event> trace_events;
+
+ThreadBuffer& GetThreadBuffer() {
+    if (thread_buffer == nullptr) {
+        std::lock_guard lock{buffers_mutex};
+        auto& buffer = buffers.emplace_back(std::make_unique<ThreadBuffer>());
+        buffer->thread = static_cast<u32>(buffers.size() - 1);
+        thread_buffer = buffer.get();
+    }
+    return *thread_buffer;
+}
+
+void Drain(ThreadBuffer& buffer, std::vector<Event>& events) {
+    const u64 write_index = buffer.write_index.load(std::memory_order_acquire);
+    u64 read_index = buffer.read_index;
+    if (write_index - read_index > BUFFER_SIZE) {
+        read_index = write_index - BUFFER_SIZE;
+    }
+
+    const std::size_t first = events.size();
+    for (u64 i = read_index; i < write_index; ++i) {
+        Event& event = events.emplace_back(buffer.events[i % BUFFER_SIZE]);
+        event.thread = buffer.thread;
+    }
+
+    // Drop the scopes the thread overwrote while they were being copied
+    const u64 overwritten_index = buffer.write_index.load(std::memory_order_acquire);
+    if (overwritten_index - read_index > BUFFER_SIZE) {
+        const std::size_t dropped = static_cast<std::size_t>(
+            std::min(overwritten_index - read_index - BUFFER_SIZE, write_index - read_index));
+        events.erase(events.begin() + first, events.begin() + first + dropped);
+    }
+
+    buffer.read_index = write_index;
+}
+
+/// Escapes a string for a JSON string literal
+std::string EscapeJson(std::string_view string) {
+    std::string escaped;
+    escaped.reserve(string.size());
+    for (const char c : string) {
+        if (c == '"' || c == '\\') {
+            escaped += '\\';
+            escaped += c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            escaped += fmt::format("\\u{:04x}", static_cast<unsigned char>(c));
+        } else {
+            escaped += c;
+        }
+    }
+    return escaped;
+}
+
+} // Anonymous namespace
+
+void SetEnabled(bool enabled) {
+    g_enabled = enabled;
+}
+
+u64 Now() {
+    return static_cast<u64>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                std::chrono::steady_clock::now() - origin)
+                                .count());
+}
+
+void Record(const char* category, const char* name, u64 start) {
+    ThreadBuffer& buffer = GetThreadBuffer();
+    const u64 index = buffer.write_index.load(std::memory_order_relaxed);
+    buffer.events[index % BUFFER_SIZE] = Event{category, name, start, Now(), 0};
+    buffer.write_index.store(index + 1, std::memory_order_release);
+}
+
+void EndFrame() {
+    std::vector<Event> events;
+    {
+        std::lock_guard lock{buffers_mutex};
+        for (auto& buffer : buffers) {
+            Drain(*buffer, events);
+        }
+    }
+
+    std::map<std::pair<std::string_view, std::string_view>, ScopeStats> stats_map;
+    for (const Event& event : events) {
+        ScopeStats& stats = stats_map[{event.category, event.name}];
+        stats.category = event.category;
+        stats.name = event.name;
+        stats.time += event.end - event.start;
+        ++stats.calls;
+    }
+
+    std::vector<ScopeStats> stats;
+    stats.reserve(stats_map.size());
+    for (const auto& [key, value] : stats_map) {
+        stats.push_back(value);
+    }
+    std::sort(stats.begin(), stats.end(),
+              [](const ScopeStats& a, const ScopeStats& b) { return a.time > b.time; });
+
+    std::lock_guard lock{stats_mutex};
+    frame_stats = std::move(stats);
+
+    if (tracing) {
+        const std::size_t count = std::min(events.size(), MAX_TRACE_EVENTS - trace_events.size());
+        trace_events.insert(trace_events.end(), events.begin(), events.begin() + count);
+    }
+}
+
+std::vector<ScopeStats> GetFrameStats() {
+    std::lock_guard lock{stats_mutex};
+    return frame_stats;
+}
+
+void StartTrace() {
+    std::lock_guard lock{stats_mutex};
+    trace_events.clear();
+    tracing = true;
+}
+
+bool IsTracing() {
+    return tracing;
+}
+
+bool StopTrace(const std::string& path) {
+    // Writing can take a while, so EndFrame isn't blocked by it
+    std::vector<Event> events;
+    {
+        std::lock_guard lock{stats_mutex};
+        tracing = false;
+        events = std::move(trace_events);
+        trace_events = {};
+    }
+
+    FileUtil::IOFile file(path, "w");
+    if (!file.IsOpen()) {
+        LOG_ERROR(Common, "Failed to open {}", path);
+        return false;
+    }
+
+    file.WriteString("{\"traceEvents\":[\n");
+    for (std::size_t i = 0; i < events.size(); ++i) {
+        const Event& event = events[i];
+        file.WriteString(fmt::format(
+            "{{\"name\":\"{}\",\"cat\":\"{}\",\"ph\":\"X\",\"ts\":{:.3f},\"dur\":{:.3f},\"pid\":0,"
+            "\"tid\":{}}}{}\n",
+            EscapeJson(event.name), EscapeJson(event.category), event.start / 1000.0,
+            (event.end - event.start) / 1000.0, event.thread, i + 1 == events.size() ? "" : ","));
+    }
+    file.WriteString("]}\n");
+
+    LOG_INFO(Common, "Wrote {} scopes to {}", events.size(), path);
+    return true;
+}
+
+} // namespace Common::Profiler
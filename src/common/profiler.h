@@ -0,0 +1,92 @@
+// Copyright 2020 vvctre project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <atomic>
+#include <string>
+#include <vector>
+#include "common/common_types.h"
+
+namespace Common::Profiler {
+
+/// A timed scope. The category and name must be string literals, or live until the program exits.
+struct Event {
+    const char* category;
+    const char* name;
+    u64 start; ///< Nanoseconds since the profiler was initialized
+    u64 end;   ///< Nanoseconds since the profiler was initialized
+    u32 thread;
+};
+
+/// Time spent in a scope during the last frame
+struct ScopeStats {
+    const char* category;
+    const char* name;
+    u64 time; ///< Nanoseconds
+    u32 calls;
+};
+
+extern std::atomic<bool> g_enabled;
+
+inline bool IsEnabled() {
+    return g_enabled.load(std::memory_order_relaxed);
+}
+
+void SetEnabled(bool enabled);
+
+/// Nanoseconds since the profiler was initialized
+u64 Now();
+
+/// Records a scope that ended now in the calling thread's buffer
+void Record(const char* category, const char* name, u64 start);
+
+/**
+ * Collects the scopes every thread recorded since the last call, updates the statistics returned
+ * by GetFrameStats and adds the scopes to the trace if one is being recorded.
+ * Called once per emulated frame.
+ */
+void EndFrame();
+
+/// Gets the time spent in each scope during the last frame, slowest first
+std::vector<ScopeStats> GetFrameStats();
+
+/// Starts keeping every collected scope for a trace
+void StartTrace();
+
+bool IsTracing();
+
+/**
+ * Stops recording the trace, and writes it in the Chrome trace event format.
+ * @return whether the file was written
+ */
+bool StopTrace(const std::string& path);
+
+/// Records the time between its construction and destruction if the profiler is enabled
+class ScopedTimer {
+public:
+    ScopedTimer(const char* category, const char* name) {
+        if (IsEnabled()) {
+            this->category = category;
+            this->name = name;
+            start = Now();
+        }
+    }
+
+    ~ScopedTimer() {
+        if (category != nullptr) {
+            Record(category, name, start);
+        }
+    }
+
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+private:
+    const char* category = nullptr;
+    const char* name = nullptr;
+    u64 start = 0;
+};
+
+} // namespace Common::Profiler
@@ -0,0 +1,132 @@
+// Copyright 2020 vvctre project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <cstring>
+#include "common/file_util.h"
+#include "common/logging/log.h"
+#include "common/texture_pack.h"
+
+namespace Common::TexturePack {
+
+bool Reader::Open(const std::string& path) {
+    entries = nullptr;
+    entry_count = 0;
+    flags = 0;
+
+    if (!file.Open(path)) {
+        return false;
+    }
+
+    const std::size_t size = file.GetSize();
+    Header header;
+    if (size < sizeof(Header)) {
+        LOG_ERROR(Common_Filesystem, "{} is too small to be a texture pack", path);
+        file.Close();
+        return false;
+    }
+    std::memcpy(&header, file.GetData(), sizeof(Header));
+    if (header.magic != Magic || header.version != Version) {
+        LOG_ERROR(Common_Filesystem, "{} isn't a version {} texture pack", path, Version);
+        file.Close();
+        return false;
+    }
+    if (header.entry_count > (size - sizeof(Header)) / sizeof(Entry)) {
+        LOG_ERROR(Common_Filesystem, "{} has a truncated index", path);
+        file.Close();
+        return false;
+    }
+
+    const Entry* index = reinterpret_cast<const Entry*>(file.GetData() + sizeof(Header));
+    for (u32 i = 0; i < header.entry_count; ++i) {
+        const Entry& entry = index[i];
+        if (entry.offset > size || entry.size > size - entry.offset ||
+            (i != 0 && index[i - 1].hash >= entry.hash)) {
+            LOG_ERROR(Common_Filesystem, "{} has an invalid index entry {}", path, i);
+            file.Close();
+            return false;
+        }
+    }
+
+    entries = index;
+    entry_count = header.entry_count;
+    flags = header.flags;
+    return true;
+}
+
+bool Reader::IsOpen() const {
+    return entries != nullptr;
+}
+
+u32 Reader::GetFlags() const {
+    return flags;
+}
+
+std::size_t Reader::GetEntryCount() const {
+    return entry_count;
+}
+
+const Entry& Reader::GetEntry(std::size_t index) const {
+    return entries[index];
+}
+
+const Entry* Reader::Find(u64 hash) const {
+    const Entry* end = entries + entry_count;
+    const Entry* entry = std::lower_bound(
+        entries, end, hash, [](const Entry& entry, u64 hash) { return entry.hash < hash; });
+    if (entry == end || entry->hash != hash) {
+        return nullptr;
+    }
+    return entry;
+}
+
+const u8* Reader::GetData(const Entry& entry) const {
+    return file.GetData() + entry.offset;
+}
+
+bool Write(const std::string& path, std::vector<Texture> textures, u32 flags) {
+    std::sort(textures.begin(), textures.end(),
+              [](const Texture& a, const Texture& b) { return a.hash < b.hash; });
+    const auto duplicates = std::unique(textures.begin(), textures.end(),
+                                        [](const Texture& a, const Texture& b) {
+                                            return a.hash == b.hash;
+                                        });
+    if (duplicates != textures.end()) {
+        LOG_ERROR(Common_Filesystem, "Skipping {} textures with conflicting hashes",
+                  std::distance(duplicates, textures.end()));
+        textures.erase(duplicates, textures.end());
+    }
+
+    Header header{};
+    header.magic = Magic;
+    header.version = Version;
+    header.entry_count = static_cast<u32>(textures.size());
+    header.flags = flags;
+
+    std::vector<Entry> index(textures.size());
+    u64 offset = sizeof(Header) + sizeof(Entry) * index.size();
+    for (std::size_t i = 0; i < textures.size(); ++i) {
+        index[i].hash = textures[i].hash;
+        index[i].offset = offset;
+        index[i].size = static_cast<u32>(textures[i].data.size());
+        index[i].width = textures[i].width;
+        index[i].height = textures[i].height;
+        index[i].format = textures[i].format;
+        offset += textures[i].data.size();
+    }
+
+    FileUtil::IOFile file(path, "wb");
+    if (!file.IsOpen() || file.WriteObject(header) != 1 ||
+        file.WriteArray(index.data(), index.size()) != index.size()) {
+        return false;
+    }
+    for (const Texture& texture : textures) {
+        if (file.WriteBytes(texture.data.data(), texture.data.size()) != texture.data.size()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace Common::TexturePack
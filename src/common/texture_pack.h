@@ -0,0 +1,85 @@
+// Copyright 2020 vvctre project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <array>
+#include <string>
+#include <vector>
+#include "common/common_types.h"
+#include "common/mapped_file.h"
+#include "common/swap.h"
+
+namespace Common::TexturePack {
+
+/*
+ * A custom texture pack is a single file that replaces a directory of tex1_* images:
+ *
+ *   Header
+ *   Entry[entry_count], sorted by hash
+ *   Entry data. Every entry is a complete image file (usually PNG), so entries are compressed
+ *   individually and can be decoded independently.
+ */
+
+constexpr std::array<char, 4> Magic{'V', 'T', 'P', 'K'};
+constexpr u32 Version = 1;
+
+/// Set when every entry is named after the hash of the texture's data in 3DS memory. Entries of
+/// packs without it can be named after the hash of the decoded texture, which vvctre also tries.
+constexpr u32 SourceHashesFlag = 1 << 0;
+
+struct Header {
+    std::array<char, 4> magic;
+    u32_le version;
+    u32_le entry_count;
+    u32_le flags;
+};
+static_assert(sizeof(Header) == 16, "Header has incorrect size");
+
+struct Entry {
+    u64_le hash;
+    u64_le offset; ///< Offset of the image file from the start of the pack
+    u32_le size;   ///< Size of the image file
+    u32_le width;
+    u32_le height;
+    u32_le format;
+};
+static_assert(sizeof(Entry) == 32, "Entry has incorrect size");
+
+/// A texture pack mapped into memory
+class Reader {
+public:
+    /// Maps a texture pack and validates its index. Returns false if it isn't a valid pack.
+    bool Open(const std::string& path);
+
+    bool IsOpen() const;
+    u32 GetFlags() const;
+    std::size_t GetEntryCount() const;
+    const Entry& GetEntry(std::size_t index) const;
+
+    /// Finds a texture with a binary search of the index, returns nullptr if it isn't in the pack
+    const Entry* Find(u64 hash) const;
+
+    /// Returns the image file of an entry, which is Entry::size bytes long
+    const u8* GetData(const Entry& entry) const;
+
+private:
+    MappedFile file;
+    const Entry* entries = nullptr;
+    std::size_t entry_count = 0;
+    u32 flags = 0;
+};
+
+struct Texture {
+    u64 hash;
+    u32 width;
+    u32 height;
+    u32 format;
+    std::vector<u8> data; ///< Image file
+};
+
+/// Writes a texture pack. Returns false if the file couldn't be written.
+bool Write(const std::string& path, std::vector<Texture> textures, u32 flags = 0);
+
+} // namespace Common::TexturePack
@@ -7,6 +7,7 @@
 #include <dynarmic/A32/context.h>
 #include <dynarmic/exclusive_monitor.h>
 #include "common/assert.h"
+#include "common/profiler.h"
 #include "core/arm/dynarmic/arm_dynarmic.h"
 #include "core/arm/dynarmic/arm_dynarmic_cp15.h"
 #include "core/core.h"
@@ -75,29 +76,42 @@ public:
           memory(parent.memory) {}
     ~DynarmicUserCallbacks() = default;
 
+    std::uint32_t MemoryReadCode(VAddr vaddr) override {
+        // Translating code isn't a read by the emulated program
+        return memory.Read32(vaddr);
+    }
+
     std::uint8_t MemoryRead8(VAddr vaddr) override {
+        CheckWatchpoint(vaddr, GDBStub::BreakpointType::Read);
         return memory.Read8(vaddr);
     }
     std::uint16_t MemoryRead16(VAddr vaddr) override {
+        CheckWatchpoint(vaddr, GDBStub::BreakpointType::Read);
         return memory.Read16(vaddr);
     }
     std::uint32_t MemoryRead32(VAddr vaddr) override {
+        CheckWatchpoint(vaddr, GDBStub::BreakpointType::Read);
         return memory.Read32(vaddr);
     }
     std::uint64_t MemoryRead64(VAddr vaddr) override {
+        CheckWatchpoint(vaddr, GDBStub::BreakpointType::Read);
         return memory.Read64(vaddr);
     }
 
     void MemoryWrite8(VAddr vaddr, std::uint8_t value) override {
+        CheckWatchpoint(vaddr, GDBStub::BreakpointType::Write);
         memory.Write8(vaddr, value);
     }
     void MemoryWrite16(VAddr vaddr, std::uint16_t value) override {
+        CheckWatchpoint(vaddr, GDBStub::BreakpointType::Write);
         memory.Write16(vaddr, value);
     }
     void MemoryWrite32(VAddr vaddr, std::uint32_t value) override {
+        CheckWatchpoint(vaddr, GDBStub::BreakpointType::Write);
         memory.Write32(vaddr, value);
     }
     void MemoryWrite64(VAddr vaddr, std::uint64_t value) override {
+        CheckWatchpoint(vaddr, GDBStub::BreakpointType::Write);
         memory.Write64(vaddr, value);
     }
 
@@ -166,6 +180,14 @@ public:
         return static_cast<u64>(ticks <= 0 ? 0 : ticks);
     }
 
+    /// Halts after the current block if the access hits a watchpoint, so the GDB stub can report it
+    void CheckWatchpoint(VAddr vaddr, GDBStub::BreakpointType type) {
+        if (GDBStub::IsConnected() && GDBStub::CheckBreakpoint(vaddr, type)) {
+            GDBStub::Break(true);
+            parent.jit->HaltExecution();
+        }
+    }
+
     ARM_Dynarmic& parent;
     Core::Timing& timing;
     Kernel::SVCContext svc_context;
@@ -182,7 +204,14 @@ ARM_Dynarmic::~ARM_Dynarmic() = default;
 
 void ARM_Dynarmic::Run() {
     ASSERT(memory.GetCurrentPageTable() == current_page_table);
-    jit->Run();
+    {
+        Common::Profiler::ScopedTimer timer{"CPU", "JIT"};
+        jit->Run();
+    }
+
+    if (GDBStub::IsMemoryBreak()) {
+        ServeBreak();
+    }
 }
 
 void ARM_Dynarmic::Step() {
@@ -6,15 +6,14 @@
 
 #include <string>
 
-namespace Core {
-class System;
-}
-
 namespace Cheats {
+class CheatProgram;
+
 class CheatBase {
 public:
     virtual ~CheatBase();
-    virtual void Execute(Core::System& system) const = 0;
+    /// Appends the cheat to the program run every frame
+    virtual void Compile(CheatProgram& program) const = 0;
 
     virtual bool IsEnabled() const = 0;
     virtual void SetEnabled(bool enabled) = 0;
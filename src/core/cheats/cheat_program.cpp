@@ -0,0 +1,327 @@
+// Copyright 2020 vvctre project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <optional>
+#include "core/arm/arm_interface.h"
+#include "core/cheats/cheat_program.h"
+#include "core/core.h"
+#include "core/hle/kernel/process.h"
+#include "core/hle/service/hid/hid.h"
+#include "core/memory.h"
+
+namespace Cheats {
+
+using CheatType = GatewayCheat::CheatType;
+
+namespace {
+
+struct State {
+    u32 reg = 0;
+    u32 offset = 0;
+    u32 if_flag = 0;
+    u32 loop_count = 0;
+    std::size_t loop_back = 0;
+    bool loop_flag = false;
+};
+
+bool IsCondition(CheatType type) {
+    switch (type) {
+    case CheatType::GreaterThan32:
+    case CheatType::LessThan32:
+    case CheatType::EqualTo32:
+    case CheatType::NotEqualTo32:
+    case CheatType::GreaterThan16WithMask:
+    case CheatType::LessThan16WithMask:
+    case CheatType::EqualTo16WithMask:
+    case CheatType::NotEqualTo16WithMask:
+    case CheatType::Joker:
+        return true;
+    default:
+        return false;
+    }
+}
+
+template <typename T>
+void Write(Core::System& system, VAddr addr, T value) {
+    Memory::MemorySystem& memory = system.Memory();
+    if constexpr (sizeof(T) == 4) {
+        if (memory.Read32(addr) != value) {
+            memory.Write32(addr, value);
+            system.CPU().InvalidateCacheRange(addr, sizeof(T));
+        }
+    } else if constexpr (sizeof(T) == 2) {
+        if (memory.Read16(addr) != value) {
+            memory.Write16(addr, value);
+            system.CPU().InvalidateCacheRange(addr, sizeof(T));
+        }
+    } else {
+        if (memory.Read8(addr) != value) {
+            memory.Write8(addr, value);
+            system.CPU().InvalidateCacheRange(addr, sizeof(T));
+        }
+    }
+}
+
+/// Returns true if the condition is met
+bool Compare(Memory::MemorySystem& memory, CheatType type, VAddr addr, u32 value) {
+    const u16 mask = static_cast<u16>(~value >> 16);
+    switch (type) {
+    case CheatType::GreaterThan32:
+        return value > memory.Read32(addr);
+    case CheatType::LessThan32:
+        return value < memory.Read32(addr);
+    case CheatType::EqualTo32:
+        return value == memory.Read32(addr);
+    case CheatType::NotEqualTo32:
+        return value != memory.Read32(addr);
+    case CheatType::GreaterThan16WithMask:
+        return static_cast<u16>(value) > (mask & memory.Read16(addr));
+    case CheatType::LessThan16WithMask:
+        return static_cast<u16>(value) < (mask & memory.Read16(addr));
+    case CheatType::EqualTo16WithMask:
+        return static_cast<u16>(value) == (mask & memory.Read16(addr));
+    case CheatType::NotEqualTo16WithMask:
+        return static_cast<u16>(value) != (mask & memory.Read16(addr));
+    default:
+        UNREACHABLE();
+        return false;
+    }
+}
+
+/// D2000000 00000000 - END; offset = 0; reg = 0;
+void FullTerminate(State& state, std::size_t& pc) {
+    if (state.loop_flag) {
+        pc = state.loop_back - 1;
+    } else {
+        state = State{};
+    }
+}
+
+} // Anonymous namespace
+
+void CheatProgram::Append(const std::vector<GatewayCheat::CheatLine>& lines) {
+    const std::size_t begin = instructions.size();
+
+    for (std::size_t i = 0; i < lines.size(); ++i) {
+        const GatewayCheat::CheatLine& line = lines[i];
+        if (line.type == CheatType::Null) {
+            continue;
+        }
+
+        Instruction instruction{line.type, line.address, line.value};
+
+        if (line.type == CheatType::Patch) {
+            // EXXXXXXX YYYYYYYY
+            // The YYYYYYYY bytes to copy are in the following lines
+            const std::size_t data_lines =
+                std::min<std::size_t>((line.value + 7) / 8, lines.size() - i - 1);
+            instruction.value = std::min<u32>(line.value, static_cast<u32>(data_lines * 8));
+            instruction.patch_offset = static_cast<u32>(patch_data.size());
+
+            for (std::size_t j = 1; j <= data_lines; ++j) {
+                const GatewayCheat::CheatLine& data_line = lines[i + j];
+                for (const u32 word : {data_line.valid ? data_line.first : 0,
+                                       data_line.valid ? data_line.value : 0}) {
+                    for (std::size_t byte = 0; byte < 4; ++byte) {
+                        patch_data.push_back(static_cast<u8>(word >> (byte * 8)));
+                    }
+                }
+            }
+            patch_data.resize(instruction.patch_offset + instruction.value);
+
+            i += data_lines;
+        }
+
+        instructions.push_back(instruction);
+    }
+
+    ResolveSkipTargets(begin, instructions.size());
+    cheats.emplace_back(static_cast<u32>(begin), static_cast<u32>(instructions.size()));
+}
+
+void CheatProgram::ResolveSkipTargets(std::size_t begin, std::size_t end) {
+    for (std::size_t i = begin; i < end; ++i) {
+        Instruction& condition = instructions[i];
+        if (!IsCondition(condition.type)) {
+            continue;
+        }
+
+        // Skip to the END IF of the block, or to the first END, which depends on the loop state
+        condition.skip_target = static_cast<u32>(end);
+        u32 depth = 1;
+        for (std::size_t j = i + 1; j < end; ++j) {
+            const CheatType type = instructions[j].type;
+            if (IsCondition(type)) {
+                ++depth;
+            } else if (type == CheatType::Terminator && --depth == 0) {
+                condition.skip_target = static_cast<u32>(j);
+                condition.skip_depth = 1;
+                break;
+            } else if (type == CheatType::FullTerminator) {
+                condition.skip_target = static_cast<u32>(j);
+                condition.skip_depth = depth;
+                break;
+            }
+        }
+    }
+}
+
+void CheatProgram::Clear() {
+    instructions.clear();
+    patch_data.clear();
+    cheats.clear();
+}
+
+void CheatProgram::Execute(Core::System& system) const {
+    Memory::MemorySystem& memory = system.Memory();
+    std::optional<u32> pad_state;
+
+    for (const auto& [begin, end] : cheats) {
+        State state;
+
+        for (std::size_t pc = begin; pc < end; ++pc) {
+            const Instruction& instruction = instructions[pc];
+
+            if (state.if_flag > 0) {
+                // Only reached after an END jumped back to a loop in a skipped block
+                if (IsCondition(instruction.type)) {
+                    ++state.if_flag;
+                } else if (instruction.type == CheatType::Terminator) {
+                    --state.if_flag;
+                } else if (instruction.type == CheatType::FullTerminator) {
+                    FullTerminate(state, pc);
+                }
+                continue;
+            }
+
+            switch (instruction.type) {
+            case CheatType::Write32:
+                // 0XXXXXXX YYYYYYYY - word[XXXXXXX+offset] = YYYYYYYY
+                Write<u32>(system, instruction.address + state.offset, instruction.value);
+                break;
+            case CheatType::Write16:
+                // 1XXXXXXX 0000YYYY - half[XXXXXXX+offset] = YYYY
+                Write<u16>(system, instruction.address + state.offset,
+                           static_cast<u16>(instruction.value));
+                break;
+            case CheatType::Write8:
+                // 2XXXXXXX 000000YY - byte[XXXXXXX+offset] = YY
+                Write<u8>(system, instruction.address + state.offset,
+                          static_cast<u8>(instruction.value));
+                break;
+            case CheatType::GreaterThan32:
+            case CheatType::LessThan32:
+            case CheatType::EqualTo32:
+            case CheatType::NotEqualTo32:
+            case CheatType::GreaterThan16WithMask:
+            case CheatType::LessThan16WithMask:
+            case CheatType::EqualTo16WithMask:
+            case CheatType::NotEqualTo16WithMask:
+                // 3XXXXXXX - AXXXXXXX - Execute next block IF the condition is met
+                if (!Compare(memory, instruction.type, instruction.address + state.offset,
+                             instruction.value)) {
+                    state.if_flag = instruction.skip_depth;
+                    pc = instruction.skip_target - 1;
+                }
+                break;
+            case CheatType::LoadOffset:
+                // BXXXXXXX 00000000 - offset = word[XXXXXXX+offset]
+                state.offset = memory.Read32(instruction.address + state.offset);
+                break;
+            case CheatType::Loop:
+                // C0000000 YYYYYYYY - LOOP next block YYYYYYYY times
+                state.loop_flag = state.loop_count < instruction.value;
+                state.loop_count++;
+                state.loop_back = pc;
+                break;
+            case CheatType::Terminator:
+                // D0000000 00000000 - END IF
+                break;
+            case CheatType::LoopExecuteVariant:
+                // D1000000 00000000 - END LOOP
+                if (state.loop_flag) {
+                    pc = state.loop_back - 1;
+                } else {
+                    state.loop_count = 0;
+                }
+                break;
+            case CheatType::FullTerminator:
+                // D2000000 00000000 - NEXT & Flush
+                FullTerminate(state, pc);
+                break;
+            case CheatType::SetOffset:
+                // D3000000 XXXXXXXX - Sets the offset to XXXXXXXX
+                state.offset = instruction.value;
+                break;
+            case CheatType::AddValue:
+                // D4000000 XXXXXXXX - reg += XXXXXXXX
+                state.reg += instruction.value;
+                break;
+            case CheatType::SetValue:
+                // D5000000 XXXXXXXX - reg = XXXXXXXX
+                state.reg = instruction.value;
+                break;
+            case CheatType::IncrementiveWrite32:
+                // D6000000 XXXXXXXX - (32bit) [XXXXXXXX+offset] = reg ; offset += 4
+                Write<u32>(system, instruction.value + state.offset, state.reg);
+                state.offset += 4;
+                break;
+            case CheatType::IncrementiveWrite16:
+                // D7000000 XXXXXXXX - (16bit) [XXXXXXXX+offset] = reg & 0xffff ; offset += 2
+                Write<u16>(system, instruction.value + state.offset, static_cast<u16>(state.reg));
+                state.offset += 2;
+                break;
+            case CheatType::IncrementiveWrite8:
+                // D8000000 XXXXXXXX - (8bit) [XXXXXXXX+offset] = reg & 0xff ; offset++
+                Write<u8>(system, instruction.value + state.offset, static_cast<u8>(state.reg));
+                state.offset += 1;
+                break;
+            case CheatType::Load32:
+                // D9000000 XXXXXXXX - reg = [XXXXXXXX+offset]
+                state.reg = memory.Read32(instruction.value + state.offset);
+                break;
+            case CheatType::Load16:
+                // DA000000 XXXXXXXX - reg = [XXXXXXXX+offset] & 0xFFFF
+                state.reg = memory.Read16(instruction.value + state.offset);
+                break;
+            case CheatType::Load8:
+                // DB000000 XXXXXXXX - reg = [XXXXXXXX+offset] & 0xFF
+                state.reg = memory.Read8(instruction.value + state.offset);
+                break;
+            case CheatType::AddOffset:
+                // DC000000 XXXXXXXX - offset + XXXXXXXX
+                state.offset += instruction.value;
+                break;
+            case CheatType::Joker:
+                // DD000000 XXXXXXXX - if KEYPAD has value XXXXXXXX execute next block
+                if (!pad_state) {
+                    pad_state = system.ServiceManager()
+                                    .GetService<Service::HID::Module::Interface>("hid:USER")
+                                    ->GetModule()
+                                    ->GetPadState()
+                                    .hex;
+                }
+                if ((*pad_state & instruction.value) != instruction.value) {
+                    state.if_flag = instruction.skip_depth;
+                    pc = instruction.skip_target - 1;
+                }
+                break;
+            case CheatType::Patch: {
+                // EXXXXXXX YYYYYYYY
+                // Copies YYYYYYYY bytes from (current code location + 8) to [XXXXXXXX + offset].
+                const VAddr addr = instruction.address + state.offset;
+                system.CPU().InvalidateCacheRange(addr, instruction.value);
+                memory.WriteBlock(*system.Kernel().GetCurrentProcess(), addr,
+                                  patch_data.data() + instruction.patch_offset, instruction.value);
+                break;
+            }
+            default:
+                break;
+            }
+        }
+    }
+}
+
+} // namespace Cheats
@@ -0,0 +1,52 @@
+// Copyright 2020 vvctre project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <utility>
+#include <vector>
+#include "common/common_types.h"
+#include "core/cheats/gateway_cheat.h"
+
+namespace Core {
+class System;
+} // namespace Core
+
+namespace Cheats {
+
+/**
+ * Gateway cheats compiled into compact instructions, so they run without copying the parsed lines,
+ * walking skipped blocks line by line or decoding patch data every frame.
+ * The cheats are executed one after the other in a single pass, each starting with a clean state.
+ */
+class CheatProgram {
+public:
+    /// Compiles a cheat and appends it to the program
+    void Append(const std::vector<GatewayCheat::CheatLine>& lines);
+
+    void Clear();
+
+    void Execute(Core::System& system) const;
+
+private:
+    struct Instruction {
+        GatewayCheat::CheatType type;
+        u32 address;
+        u32 value;
+        u32 skip_target = 0;  ///< Where a false condition continues, the end of its block
+        u32 skip_depth = 0;   ///< Number of unterminated conditions at skip_target
+        u32 patch_offset = 0; ///< Offset of a patch's bytes in patch_data
+    };
+
+    /// Finds where each condition continues when it's false
+    void ResolveSkipTargets(std::size_t begin, std::size_t end);
+
+    std::vector<Instruction> instructions;
+    std::vector<u8> patch_data;
+
+    /// Instruction range of each cheat
+    std::vector<std::pair<u32, u32>> cheats;
+};
+
+} // namespace Cheats
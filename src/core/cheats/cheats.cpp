@@ -101,11 +101,29 @@ void CheatEngine::LoadCheatFile() {
 void CheatEngine::RunCallback([[maybe_unused]] u64 userdata, int cycles_late) {
     {
         std::shared_lock<std::shared_mutex> lock(cheats_list_mutex);
-        for (auto& cheat : cheats_list) {
+
+        std::size_t enabled_count = 0;
+        bool changed = false;
+        for (const auto& cheat : cheats_list) {
             if (cheat->IsEnabled()) {
-                cheat->Execute(system);
+                changed = changed || enabled_count == compiled_cheats.size() ||
+                          compiled_cheats[enabled_count] != cheat;
+                ++enabled_count;
             }
         }
+
+        if (changed || enabled_count != compiled_cheats.size()) {
+            program.Clear();
+            compiled_cheats.clear();
+            for (const auto& cheat : cheats_list) {
+                if (cheat->IsEnabled()) {
+                    cheat->Compile(program);
+                    compiled_cheats.push_back(cheat);
+                }
+            }
+        }
+
+        program.Execute(system);
     }
     system.CoreTiming().ScheduleEvent(run_interval_ticks - cycles_late, event);
 }
@@ -8,6 +8,7 @@
 #include <shared_mutex>
 #include <vector>
 #include "common/common_types.h"
+#include "core/cheats/cheat_program.h"
 
 namespace Core {
 class System;
@@ -39,6 +40,10 @@ private:
 
     std::vector<std::shared_ptr<CheatBase>> cheats_list;
     mutable std::shared_mutex cheats_list_mutex;
+
+    /// The enabled cheats, compiled when the list or their enabled state changes
+    CheatProgram program;
+    std::vector<std::shared_ptr<CheatBase>> compiled_cheats;
     Core::TimingEventType* event;
     Core::System& system;
 };
@@ -57,7 +57,7 @@ public:
     GatewayCheat(std::string name, std::string code, std::string comments);
     ~GatewayCheat();
 
-    void Execute(Core::System& system) const override;
+    void Compile(CheatProgram& program) const override;
 
     bool IsEnabled() const override;
     void SetEnabled(bool enabled) override;
@@ -292,6 +292,7 @@ void System::RegisterSoftwareKeyboard(std::shared_ptr<Frontend::SoftwareKeyboard
 }
 
 void System::Shutdown() {
+    frame_dumper.Stop();
     GDBStub::Shutdown();
     VideoCore::Shutdown();
     perf_stats.reset();
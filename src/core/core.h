@@ -9,6 +9,7 @@
 #include <string>
 #include "common/common_types.h"
 #include "core/custom_tex_cache.h"
+#include "core/frame_dumper.h"
 #include "core/frontend/applets/mii_selector.h"
 #include "core/frontend/applets/swkbd.h"
 #include "core/loader/loader.h"
@@ -199,6 +200,7 @@ public:
 
     std::unique_ptr<PerfStats> perf_stats;
     FrameLimiter frame_limiter;
+    FrameDumper frame_dumper;
 
     void SetStatus(ResultStatus new_status, const char* details = nullptr) {
         status = new_status;
@@ -7,6 +7,7 @@
 #include <tuple>
 #include "common/assert.h"
 #include "common/logging/log.h"
+#include "common/profiler.h"
 #include "core/core_timing.h"
 #include "core/settings.h"
 
@@ -114,6 +115,8 @@ void Timing::MoveEvents() {
 }
 
 void Timing::Advance() {
+    Common::Profiler::ScopedTimer timer{"Core", "Timing Events"};
+
     MoveEvents();
 
     s64 cycles_executed = slice_length - downcount;
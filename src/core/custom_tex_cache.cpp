@@ -2,40 +2,247 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
+#include <bitset>
+#include <cstring>
+#include <optional>
+#include <set>
+#include <sstream>
 #include <fmt/format.h>
 #include <stb_image.h>
 #include "common/file_util.h"
 #include "common/texture.h"
 #include "core/core.h"
 #include "core/custom_tex_cache.h"
+#include "core/settings.h"
 
 namespace Core {
 
-CustomTexCache::CustomTexCache() = default;
+static std::optional<CustomTexInfo> DecodeImage(const u8* data, std::size_t size,
+                                                const std::string& name) {
+    CustomTexInfo tex_info;
+    unsigned char* image =
+        stbi_load_from_memory(data, static_cast<int>(size), reinterpret_cast<int*>(&tex_info.width),
+                              reinterpret_cast<int*>(&tex_info.height), nullptr, 4);
+    if (image == nullptr) {
+        LOG_ERROR(Render_OpenGL, "Failed to load custom texture {}", name);
+        return std::nullopt;
+    }
+
+    tex_info.tex.resize(tex_info.width * tex_info.height * 4);
+    std::memcpy(tex_info.tex.data(), image, tex_info.tex.size());
+    free(image);
+
+    // Make sure the texture size is a power of 2
+    std::bitset<32> width_bits(tex_info.width);
+    std::bitset<32> height_bits(tex_info.height);
+    if (width_bits.count() != 1 || height_bits.count() != 1) {
+        LOG_ERROR(Render_OpenGL, "Texture {} size is not a power of 2", name);
+        return std::nullopt;
+    }
+
+    LOG_DEBUG(Render_OpenGL, "Loaded custom texture from {}", name);
+    Common::FlipRGBA8Texture(tex_info.tex, tex_info.width, tex_info.height);
+    return tex_info;
+}
+
+CustomTexCache::CustomTexCache()
+    : memory_budget{static_cast<std::size_t>(Settings::values.custom_textures_memory) * 0x100000} {}
+
+CustomTexCache::~CustomTexCache() {
+    {
+        std::lock_guard lock(mutex);
+        stop_workers = true;
+        decode_queue.clear();
+    }
+    decode_cv.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    if (!legacy_hashes.empty() && !hash_map_path.empty() &&
+        FileUtil::CreateFullPath(hash_map_path)) {
+        // Skip the pairs recorded by earlier sessions
+        std::set<std::pair<u64, u64>> recorded;
+        std::string contents;
+        FileUtil::ReadFileToString(true, hash_map_path, contents);
+        std::istringstream stream(contents);
+        u64 legacy_hash, source_hash;
+        while (stream >> std::hex >> legacy_hash >> source_hash) {
+            recorded.emplace(legacy_hash, source_hash);
+        }
+
+        FileUtil::IOFile file(hash_map_path, "a");
+        for (const auto& pair : legacy_hashes) {
+            if (!recorded.count(pair)) {
+                file.WriteString(fmt::format("{:016X} {:016X}\n", pair.first, pair.second));
+            }
+        }
+    }
+}
+
+std::shared_ptr<const CustomTexInfo> CustomTexCache::GetTexture(u64 hash) {
+    std::lock_guard lock(mutex);
+
+    const auto it = custom_textures.find(hash);
+    if (it != custom_textures.end()) {
+        lru.splice(lru.begin(), lru, it->second.lru_position);
+        return it->second.info;
+    }
+
+    if (!failed_textures.count(hash) && CustomTextureExistsLocked(hash)) {
+        QueueTexture(hash, false);
+    }
+    return nullptr;
+}
+
+bool CustomTexCache::IsTextureReady(u64 hash) const {
+    std::lock_guard lock(mutex);
+    return !queued_textures.count(hash);
+}
+
+bool CustomTexCache::HasTextureFailed(u64 hash) const {
+    std::lock_guard lock(mutex);
+    return failed_textures.count(hash);
+}
+
+void CustomTexCache::QueueTexture(u64 hash, bool preload) {
+    if (!queued_textures.insert(hash).second) {
+        if (!preload) {
+            // Move a preloaded texture that's needed now to the front of the queue
+            const auto it = std::find_if(decode_queue.begin(), decode_queue.end(),
+                                         [hash](const DecodeRequest& request) {
+                                             return request.hash == hash && request.preload;
+                                         });
+            if (it != decode_queue.end()) {
+                decode_queue.erase(it);
+                decode_queue.push_front({hash, false});
+            }
+        }
+        return;
+    }
+
+    // Textures that are needed now go before the preloaded ones
+    if (preload) {
+        decode_queue.push_back({hash, true});
+    } else {
+        decode_queue.push_front({hash, false});
+    }
 
-CustomTexCache::~CustomTexCache() = default;
+    if (workers.empty()) {
+        const unsigned int worker_count = std::max(std::thread::hardware_concurrency() / 2, 1U);
+        for (unsigned int i = 0; i < worker_count; ++i) {
+            workers.emplace_back(&CustomTexCache::WorkerLoop, this);
+        }
+    }
+    decode_cv.notify_one();
+}
 
-bool CustomTexCache::IsTextureDumped(u64 hash) const {
-    return dumped_textures.count(hash);
+std::optional<CustomTexInfo> CustomTexCache::DecodeTexture(u64 hash,
+                                                           const std::string& path) const {
+    // Loose files take precedence over the texture pack
+    if (!path.empty()) {
+        FileUtil::IOFile file(path, "rb");
+        std::vector<u8> data(file.GetSize());
+        if (!file.IsOpen() || file.ReadBytes(data.data(), data.size()) != data.size()) {
+            LOG_ERROR(Render_OpenGL, "Failed to read custom texture {}", path);
+            return std::nullopt;
+        }
+        return DecodeImage(data.data(), data.size(), path);
+    }
+
+    const Common::TexturePack::Entry* entry = texture_pack.Find(hash);
+    return DecodeImage(texture_pack.GetData(*entry), entry->size,
+                       fmt::format("{:016X} in the texture pack", hash));
 }
 
-void CustomTexCache::SetTextureDumped(const u64 hash) {
-    dumped_textures.insert(hash);
+void CustomTexCache::WorkerLoop() {
+    std::unique_lock lock(mutex);
+    for (;;) {
+        decode_cv.wait(lock, [this] { return stop_workers || !decode_queue.empty(); });
+        if (stop_workers) {
+            return;
+        }
+
+        const DecodeRequest request = decode_queue.front();
+        decode_queue.pop_front();
+
+        if (request.preload && cached_bytes >= memory_budget) {
+            queued_textures.erase(request.hash);
+            DropPreloads();
+            continue;
+        }
+
+        // Copy the path so the map isn't read without the mutex
+        const auto path_info = custom_texture_paths.find(request.hash);
+        const std::string path =
+            path_info != custom_texture_paths.end() ? path_info->second.path : std::string{};
+
+        lock.unlock();
+        std::optional<CustomTexInfo> tex_info = DecodeTexture(request.hash, path);
+        lock.lock();
+
+        queued_textures.erase(request.hash);
+        if (!tex_info) {
+            failed_textures.insert(request.hash);
+            continue;
+        }
+
+        const std::size_t size = tex_info->tex.size();
+        if (request.preload && cached_bytes + size > memory_budget) {
+            // The cache is full, so decoding the remaining preloads would only waste time
+            DropPreloads();
+            continue;
+        }
+
+        // Evict the least recently used textures. Surfaces that already uploaded them keep their
+        // OpenGL copy, and they're decoded again if they're needed later.
+        while (!lru.empty() && cached_bytes + size > memory_budget) {
+            const auto evicted = custom_textures.find(lru.back());
+            cached_bytes -= evicted->second.info->tex.size();
+            custom_textures.erase(evicted);
+            lru.pop_back();
+        }
+
+        lru.push_front(request.hash);
+        custom_textures[request.hash] = {
+            std::make_shared<const CustomTexInfo>(std::move(*tex_info)), lru.begin()};
+        cached_bytes += size;
+    }
 }
 
-bool CustomTexCache::IsTextureCached(u64 hash) const {
-    return custom_textures.count(hash);
+void CustomTexCache::DropPreloads() {
+    const auto preloads_begin =
+        std::stable_partition(decode_queue.begin(), decode_queue.end(),
+                              [](const DecodeRequest& request) { return !request.preload; });
+    for (auto it = preloads_begin; it != decode_queue.end(); ++it) {
+        queued_textures.erase(it->hash);
+    }
+    decode_queue.erase(preloads_begin, decode_queue.end());
+}
+
+void CustomTexCache::MapLegacyHash(u64 legacy_hash, u64 source_hash) {
+    legacy_hashes.emplace(legacy_hash, source_hash);
 }
 
-const CustomTexInfo& CustomTexCache::LookupTexture(u64 hash) const {
-    return custom_textures.at(hash);
+bool CustomTexCache::NeedsLegacyHash(u64 source_hash) const {
+    if (legacy_hash_misses.count(source_hash)) {
+        return false;
+    }
+
+    // Loose files can be named after either hash
+    std::lock_guard lock(mutex);
+    return !custom_texture_paths.empty() ||
+           (texture_pack.IsOpen() &&
+            !(texture_pack.GetFlags() & Common::TexturePack::SourceHashesFlag));
 }
 
-void CustomTexCache::CacheTexture(u64 hash, const std::vector<u8>& tex, u32 width, u32 height) {
-    custom_textures[hash] = {width, height, tex};
+void CustomTexCache::AddLegacyHashMiss(u64 source_hash) {
+    legacy_hash_misses.insert(source_hash);
 }
 
 void CustomTexCache::AddTexturePath(u64 hash, const std::string& path) {
+    std::lock_guard lock(mutex);
     if (custom_texture_paths.count(hash)) {
         LOG_ERROR(Core, "Textures {} and {} conflict!", custom_texture_paths[hash].path, path);
     } else {
@@ -46,10 +253,21 @@ void CustomTexCache::AddTexturePath(u64 hash, const std::string& path) {
 void CustomTexCache::FindCustomTextures() {
     // Custom textures are currently stored as
     // [TitleID]/tex1_[width]x[height]_[64-bit hash]_[format].[extension]
+    // or packed into [TitleID].vtpk by vvctre-texture-pack-builder
+
+    const u64 program_id =
+        Core::System::GetInstance().Kernel().GetCurrentProcess()->codeset->program_id;
+    const std::string pack_path = fmt::format(
+        "{}textures/{:016X}.vtpk", FileUtil::GetUserPath(FileUtil::UserPath::LoadDir), program_id);
+    if (FileUtil::Exists(pack_path) && texture_pack.Open(pack_path)) {
+        LOG_INFO(Render_OpenGL, "Using {} textures from {}", texture_pack.GetEntryCount(),
+                 pack_path);
+    }
 
-    const std::string load_path =
-        fmt::format("{}textures/{:016X}/", FileUtil::GetUserPath(FileUtil::UserPath::LoadDir),
-                    Core::System::GetInstance().Kernel().GetCurrentProcess()->codeset->program_id);
+    const std::string load_path = fmt::format(
+        "{}textures/{:016X}/", FileUtil::GetUserPath(FileUtil::UserPath::LoadDir), program_id);
+    hash_map_path = fmt::format("{}textures/{:016X}.hashmap",
+                                FileUtil::GetUserPath(FileUtil::UserPath::DumpDir), program_id);
 
     if (FileUtil::Exists(load_path)) {
         FileUtil::FSTEntry texture_dir;
@@ -81,42 +299,31 @@ void CustomTexCache::FindCustomTextures() {
 }
 
 void CustomTexCache::PreloadTextures() {
+    std::lock_guard lock(mutex);
     for (const auto& path : custom_texture_paths) {
-        const auto& path_info = path.second;
-        Core::CustomTexInfo tex_info;
-        unsigned char* image =
-            stbi_load(path_info.path.c_str(), reinterpret_cast<int*>(&tex_info.width),
-                      reinterpret_cast<int*>(&tex_info.height), nullptr, 4);
-        if (image != nullptr) {
-            tex_info.tex.resize(tex_info.width * tex_info.height * 4);
-            std::memcpy(tex_info.tex.data(), image, tex_info.tex.size());
-            free(image);
-
-            // Make sure the texture size is a power of 2
-            std::bitset<32> width_bits(tex_info.width);
-            std::bitset<32> height_bits(tex_info.height);
-            if (width_bits.count() == 1 && height_bits.count() == 1) {
-                LOG_DEBUG(Render_OpenGL, "Loaded custom texture from {}", path_info.path);
-                Common::FlipRGBA8Texture(tex_info.tex, tex_info.width, tex_info.height);
-                CacheTexture(path_info.hash, tex_info.tex, tex_info.width, tex_info.height);
-            } else {
-                LOG_ERROR(Render_OpenGL, "Texture {} size is not a power of 2", path_info.path);
-            }
-        } else {
-            LOG_ERROR(Render_OpenGL, "Failed to load custom texture {}", path_info.path);
-        }
+        QueueTexture(path.first, true);
+    }
+    for (std::size_t i = 0; i < texture_pack.GetEntryCount(); ++i) {
+        QueueTexture(texture_pack.GetEntry(i).hash, true);
     }
 }
 
 bool CustomTexCache::CustomTextureExists(u64 hash) const {
-    return custom_texture_paths.count(hash);
+    std::lock_guard lock(mutex);
+    return CustomTextureExistsLocked(hash);
+}
+
+bool CustomTexCache::CustomTextureExistsLocked(u64 hash) const {
+    return custom_texture_paths.count(hash) || texture_pack.Find(hash) != nullptr;
 }
 
 const CustomTexPathInfo& CustomTexCache::LookupTexturePathInfo(u64 hash) const {
+    std::lock_guard lock(mutex);
     return custom_texture_paths.at(hash);
 }
 
 bool CustomTexCache::IsTexturePathMapEmpty() const {
+    std::lock_guard lock(mutex);
     return custom_texture_paths.size() == 0;
 }
 
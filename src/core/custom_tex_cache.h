@@ -4,11 +4,19 @@
 
 #pragma once
 
+#include <condition_variable>
+#include <deque>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <optional>
 #include <string>
+#include <thread>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
 #include "common/common_types.h"
+#include "common/texture_pack.h"
 
 namespace Core {
 struct CustomTexInfo {
@@ -29,23 +37,89 @@ public:
     explicit CustomTexCache();
     ~CustomTexCache();
 
-    bool IsTextureDumped(u64 hash) const;
-    void SetTextureDumped(u64 hash);
+    /**
+     * Returns the decoded custom texture for hash. If it isn't decoded yet, it's queued for
+     * decoding on a worker thread and nullptr is returned, so the original texture can be used in
+     * the meantime.
+     */
+    std::shared_ptr<const CustomTexInfo> GetTexture(u64 hash);
 
-    bool IsTextureCached(u64 hash) const;
-    const CustomTexInfo& LookupTexture(u64 hash) const;
-    void CacheTexture(u64 hash, const std::vector<u8>& tex, u32 width, u32 height);
+    /// Returns false while the texture is queued for decoding or being decoded
+    bool IsTextureReady(u64 hash) const;
+
+    /// Returns true if the texture couldn't be decoded
+    bool HasTextureFailed(u64 hash) const;
+
+    /**
+     * Records that a custom texture named after the hash of the decoded texture was used for the
+     * texture with source_hash. The pairs are appended to textures/[TitleID].hashmap in the dump
+     * directory, which vvctre-texture-pack-builder uses to rename old custom textures.
+     */
+    void MapLegacyHash(u64 legacy_hash, u64 source_hash);
+
+    /**
+     * Returns true if the texture with source_hash may be replaced by a custom texture named after
+     * the hash of the decoded texture. That's never the case when every custom texture is in a pack
+     * built with --source-hashes, or after no custom texture matched that texture's old hash.
+     */
+    bool NeedsLegacyHash(u64 source_hash) const;
+
+    /// Records that no custom texture is named after the old hash of the texture with source_hash
+    void AddLegacyHashMiss(u64 source_hash);
 
     void AddTexturePath(u64 hash, const std::string& path);
     void FindCustomTextures();
+
+    /// Queues every custom texture for decoding, stopping once the memory budget is full
     void PreloadTextures();
+
     bool CustomTextureExists(u64 hash) const;
     const CustomTexPathInfo& LookupTexturePathInfo(u64 hash) const;
     bool IsTexturePathMapEmpty() const;
 
 private:
-    std::unordered_set<u64> dumped_textures;
-    std::unordered_map<u64, CustomTexInfo> custom_textures;
-    std::unordered_map<u64, CustomTexPathInfo> custom_texture_paths;
+    struct DecodeRequest {
+        u64 hash;
+        bool preload; ///< Preloaded textures don't evict others from the cache
+    };
+
+    struct CachedTexture {
+        std::shared_ptr<const CustomTexInfo> info;
+        std::list<u64>::iterator lru_position;
+    };
+
+    /// Queues a texture for decoding. The mutex must be held.
+    void QueueTexture(u64 hash, bool preload);
+
+    /// CustomTextureExists without locking the mutex. The mutex must be held.
+    bool CustomTextureExistsLocked(u64 hash) const;
+
+    /// Reads and decodes a texture from its loose file, or from the texture pack if path is empty
+    std::optional<CustomTexInfo> DecodeTexture(u64 hash, const std::string& path) const;
+
+    void WorkerLoop();
+
+    /// Removes the preloads that haven't started decoding from the queue. The mutex must be held.
+    void DropPreloads();
+
+    std::unordered_map<u64, CustomTexPathInfo> custom_texture_paths; ///< Guarded by mutex
+    Common::TexturePack::Reader texture_pack;
+
+    std::string hash_map_path;
+    std::unordered_map<u64, u64> legacy_hashes;
+    std::unordered_set<u64> legacy_hash_misses;
+
+    mutable std::mutex mutex;
+    std::unordered_map<u64, CachedTexture> custom_textures;
+    std::list<u64> lru; ///< Decoded textures, most recently used first
+    std::size_t cached_bytes = 0;
+    std::size_t memory_budget;
+    std::unordered_set<u64> queued_textures;
+    std::unordered_set<u64> failed_textures;
+
+    std::condition_variable decode_cv;
+    std::deque<DecodeRequest> decode_queue;
+    bool stop_workers = false;
+    std::vector<std::thread> workers;
 };
 } // namespace Core
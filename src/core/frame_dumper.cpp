@@ -0,0 +1,220 @@
+// Copyright 2020 vvctre project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <limits>
+#include <fmt/format.h>
+#include "audio_core/audio_types.h"
+#include "common/logging/log.h"
+#include "common/string_util.h"
+#include "core/core_timing.h"
+#include "core/frame_dumper.h"
+#include "core/hw/gpu.h"
+#include "video_core/renderer_base.h"
+#include "video_core/video_core.h"
+
+namespace Core {
+
+/// Audio is queued in packets of at least this many sample pairs
+constexpr std::size_t AUDIO_PACKET_SIZE = AudioCore::samples_per_frame;
+
+/// Size of the RIFF and fmt chunk headers and the data chunk header of the WAV file
+constexpr std::size_t WAV_HEADER_SIZE = 44;
+
+static void WriteWavHeader(FileUtil::IOFile& file, u64 data_size) {
+    // The sizes are 32-bit, so longer audio is only readable up to the clamped size
+    constexpr u64 max_data_size = std::numeric_limits<u32>::max() - (WAV_HEADER_SIZE - 8);
+    if (data_size > max_data_size) {
+        LOG_WARNING(Render, "The audio is longer than a WAV file can hold, its size is clamped");
+        data_size = max_data_size;
+    }
+
+    const auto write_u32 = [&file](u32 value) { file.WriteObject(value); };
+    const auto write_u16 = [&file](u16 value) { file.WriteObject(value); };
+
+    file.WriteString("RIFF");
+    write_u32(static_cast<u32>(WAV_HEADER_SIZE - 8 + data_size));
+    file.WriteString("WAVE");
+    file.WriteString("fmt ");
+    write_u32(16);
+    write_u16(1); // PCM
+    write_u16(2); // Channels
+    write_u32(AudioCore::native_sample_rate);
+    write_u32(AudioCore::native_sample_rate * 2 * sizeof(s16));
+    write_u16(2 * sizeof(s16));
+    write_u16(16);
+    file.WriteString("data");
+    write_u32(static_cast<u32>(data_size));
+}
+
+FrameDumper::FrameDumper() = default;
+
+FrameDumper::~FrameDumper() {
+    Stop();
+}
+
+bool FrameDumper::Start(const std::string& path, const Layout::FramebufferLayout& layout) {
+    Stop();
+    stop_requested = false;
+
+    video_file = FileUtil::IOFile(path, "wb");
+    audio_file = FileUtil::IOFile(path + ".wav", "wb");
+    if (!video_file.IsOpen() || !audio_file.IsOpen()) {
+        LOG_ERROR(Render, "Failed to create the dump files for {}", path);
+        video_file.Close();
+        audio_file.Close();
+        return false;
+    }
+
+    this->layout = layout;
+    const std::string lower_path = Common::ToLower(path);
+    y4m = lower_path.size() >= 4 && lower_path.compare(lower_path.size() - 4, 4, ".y4m") == 0;
+
+    if (y4m) {
+        video_file.WriteString(fmt::format("YUV4MPEG2 W{} H{} F{}:{} Ip A1:1 C444\n", layout.width,
+                                           layout.height, BASE_CLOCK_RATE_ARM11,
+                                           GPU::frame_ticks));
+    }
+
+    audio_bytes = 0;
+    WriteWavHeader(audio_file, 0);
+
+    pending_audio.clear();
+    write_thread = std::thread(&FrameDumper::WriteThread, this);
+    dumping = true;
+
+    LOG_INFO(Render, "Dumping {}x{} frames to {}", layout.width, layout.height, path);
+    return true;
+}
+
+void FrameDumper::Stop() {
+    if (!dumping) {
+        return;
+    }
+
+    // Send the frames the renderer is still reading back
+    if (VideoCore::g_renderer) {
+        VideoCore::g_renderer->FlushFrameDump();
+    }
+
+    dumping = false;
+    stop_requested = false;
+    FlushAudio();
+    queue.Push(Packet{});
+    write_thread.join();
+
+    audio_file.Seek(0, SEEK_SET);
+    WriteWavHeader(audio_file, audio_bytes);
+    audio_file.Close();
+    video_file.Close();
+
+    LOG_INFO(Render, "Stopped dumping frames");
+}
+
+void FrameDumper::RequestStop() {
+    stop_requested = true;
+}
+
+bool FrameDumper::IsStopRequested() const {
+    return stop_requested;
+}
+
+bool FrameDumper::IsDumping() const {
+    return dumping;
+}
+
+const Layout::FramebufferLayout& FrameDumper::GetLayout() const {
+    return layout;
+}
+
+void FrameDumper::AddVideoFrame(std::vector<u8> frame) {
+    if (!dumping) {
+        return;
+    }
+
+    Packet packet;
+    packet.type = PacketType::Video;
+    packet.video = std::move(frame);
+    queue.Push(std::move(packet));
+}
+
+void FrameDumper::AddAudioSamples(const s16* samples, std::size_t count) {
+    if (!dumping) {
+        return;
+    }
+
+    pending_audio.insert(pending_audio.end(), samples, samples + count * 2);
+    if (pending_audio.size() >= AUDIO_PACKET_SIZE * 2) {
+        FlushAudio();
+    }
+}
+
+void FrameDumper::FlushAudio() {
+    if (pending_audio.empty()) {
+        return;
+    }
+
+    Packet packet;
+    packet.type = PacketType::Audio;
+    packet.audio = std::move(pending_audio);
+    queue.Push(std::move(packet));
+    pending_audio.clear();
+}
+
+void FrameDumper::WriteThread() {
+    for (;;) {
+        Packet packet = queue.PopWait();
+
+        switch (packet.type) {
+        case PacketType::Video:
+            WriteVideoFrame(packet.video);
+            break;
+        case PacketType::Audio:
+            audio_file.WriteArray(packet.audio.data(), packet.audio.size());
+            audio_bytes += packet.audio.size() * sizeof(s16);
+            break;
+        case PacketType::Stop:
+            return;
+        }
+    }
+}
+
+void FrameDumper::WriteVideoFrame(const std::vector<u8>& frame) {
+    const std::size_t width = layout.width;
+    const std::size_t height = layout.height;
+    if (frame.size() != width * height * 4) {
+        LOG_ERROR(Render, "Dropping a frame with an unexpected size");
+        return;
+    }
+
+    if (!y4m) {
+        // Flip the frame to top-down
+        for (std::size_t y = 0; y < height; ++y) {
+            video_file.WriteBytes(&frame[(height - 1 - y) * width * 4], width * 4);
+        }
+        return;
+    }
+
+    // BT.601 limited range, full resolution chroma
+    converted_frame.resize(width * height * 3);
+    u8* y_plane = converted_frame.data();
+    u8* u_plane = y_plane + width * height;
+    u8* v_plane = u_plane + width * height;
+    for (std::size_t y = 0; y < height; ++y) {
+        const u8* row = &frame[(height - 1 - y) * width * 4];
+        for (std::size_t x = 0; x < width; ++x) {
+            const int b = row[x * 4];
+            const int g = row[x * 4 + 1];
+            const int r = row[x * 4 + 2];
+            const std::size_t i = y * width + x;
+            y_plane[i] = static_cast<u8>(((66 * r + 129 * g + 25 * b + 128) >> 8) + 16);
+            u_plane[i] = static_cast<u8>(((-38 * r - 74 * g + 112 * b + 128) >> 8) + 128);
+            v_plane[i] = static_cast<u8>(((112 * r - 94 * g - 18 * b + 128) >> 8) + 128);
+        }
+    }
+
+    video_file.WriteString("FRAME\n");
+    video_file.WriteBytes(converted_frame.data(), converted_frame.size());
+}
+
+} // namespace Core
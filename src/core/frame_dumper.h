@@ -0,0 +1,92 @@
+// Copyright 2020 vvctre project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <string>
+#include <thread>
+#include <vector>
+#include "common/common_types.h"
+#include "common/file_util.h"
+#include "common/threadsafe_queue.h"
+#include "core/frontend/framebuffer_layout.h"
+
+namespace Core {
+
+/**
+ * Writes the presented frames and the DSP output to files on a separate thread.
+ * Video is written to a YUV4MPEG2 file if the path ends with .y4m, and as raw top-down BGRA frames
+ * otherwise. Audio is written to a WAV file next to it. One video frame is written per emulated
+ * VBlank and audio is written as the DSP produces it, so the files stay in sync no matter how fast
+ * the emulation runs.
+ * RequestStop and IsDumping can be called from any thread. The other functions must be called by
+ * the thread that runs the emulator, while it isn't running it on another thread.
+ */
+class FrameDumper {
+public:
+    FrameDumper();
+    ~FrameDumper();
+
+    /**
+     * Starts dumping.
+     * @param path the video file's path, the audio is written to the same path with .wav appended
+     * @param layout the layout to draw the screens with
+     * @return whether the files were created
+     */
+    bool Start(const std::string& path, const Layout::FramebufferLayout& layout);
+
+    /// Stops dumping, and waits for the queued frames to be written
+    void Stop();
+
+    /// Makes the renderer stop dumping after the current frame
+    void RequestStop();
+
+    bool IsStopRequested() const;
+
+    bool IsDumping() const;
+
+    const Layout::FramebufferLayout& GetLayout() const;
+
+    /// Queues a bottom-up BGRA frame with the size of the layout
+    void AddVideoFrame(std::vector<u8> frame);
+
+    /// Queues count interleaved left and right sample pairs
+    void AddAudioSamples(const s16* samples, std::size_t count);
+
+private:
+    enum class PacketType { Video, Audio, Stop };
+
+    struct Packet {
+        PacketType type = PacketType::Stop;
+        std::vector<u8> video;
+        std::vector<s16> audio;
+    };
+
+    void WriteThread();
+    void WriteVideoFrame(const std::vector<u8>& frame);
+    void FlushAudio();
+
+    std::atomic<bool> dumping{false};
+    std::atomic<bool> stop_requested{false};
+    Layout::FramebufferLayout layout{};
+    bool y4m = false;
+
+    FileUtil::IOFile video_file;
+    FileUtil::IOFile audio_file;
+    u64 audio_bytes = 0;
+
+    /// Samples waiting to be queued, the LLE DSP outputs them one at a time
+    std::vector<s16> pending_audio;
+
+    Common::SPSCQueue<Packet> queue;
+    std::thread write_thread;
+
+    // Used by the write thread only
+    std::vector<u8> converted_frame;
+};
+
+} // namespace Core
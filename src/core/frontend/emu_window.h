@@ -31,6 +31,14 @@ public:
     /// Polls window events
     virtual void PollEvents() = 0;
 
+    /**
+     * Gets the OpenGL framebuffer the renderer should draw the next frame to.
+     * The default is the window's framebuffer.
+     */
+    virtual u32 GetRenderFramebuffer() {
+        return 0;
+    }
+
     /**
      * Signal that a touch pressed event has occurred (e.g. mouse click pressed)
      * @param framebuffer_x Framebuffer x-coordinate that was pressed
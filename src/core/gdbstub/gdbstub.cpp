@@ -411,11 +411,14 @@ static void RemoveBreakpoint(BreakpointType type, VAddr addr) {
     LOG_DEBUG(Debug_GDBStub, "gdb: removed a breakpoint: {:08x} bytes at {:08x} of type {}",
               bp->second.len, bp->second.addr, static_cast<int>(type));
 
+    Core::System& system = Core::System::GetInstance();
     if (type == BreakpointType::Execute) {
-        Core::System& system = Core::System::GetInstance();
         system.Memory().WriteBlock(*system.Kernel().GetCurrentProcess(), bp->second.addr,
                                    bp->second.inst.data(), bp->second.inst.size());
-        system.CPU().ClearInstructionCache();
+        system.CPU().InvalidateCacheRange(bp->second.addr, bp->second.inst.size());
+    } else {
+        system.Memory().SetRegionWatched(*system.Kernel().GetCurrentProcess(), bp->second.addr,
+                                         bp->second.len, false);
     }
 
     p.erase(addr);
@@ -443,11 +446,13 @@ bool CheckBreakpoint(VAddr addr, BreakpointType type) {
     }
 
     const BreakpointMap& p = GetBreakpointMap(type);
-    const auto bp = p.find(addr);
 
-    if (bp == p.end()) {
+    // Find the last breakpoint starting at or before the address
+    auto bp = p.upper_bound(addr);
+    if (bp == p.begin()) {
         return false;
     }
+    --bp;
 
     u32 len = bp->second.len;
 
@@ -872,7 +877,7 @@ static void WriteMemory() {
     GdbHexToMem(data.data(), len_pos + 1, len);
 
     system.Memory().WriteBlock(*system.Kernel().GetCurrentProcess(), addr, data.data(), len);
-    system.CPU().ClearInstructionCache();
+    system.CPU().InvalidateCacheRange(addr, len);
 
     SendReply("OK");
 }
@@ -925,6 +930,9 @@ static void Continue() {
  */
 static bool CommitBreakpoint(BreakpointType type, VAddr addr, u32 len) {
     BreakpointMap& p = GetBreakpointMap(type);
+    if (p.count(addr) != 0) {
+        return true;
+    }
 
     Breakpoint breakpoint;
     breakpoint.active = true;
@@ -935,11 +943,15 @@ static bool CommitBreakpoint(BreakpointType type, VAddr addr, u32 len) {
         breakpoint.inst.size());
 
     static constexpr std::array<u8, 4> btrap{0x70, 0x00, 0x20, 0xe1};
+    Core::System& system = Core::System::GetInstance();
     if (type == BreakpointType::Execute) {
-        Core::System& system = Core::System::GetInstance();
         system.Memory().WriteBlock(*system.Kernel().GetCurrentProcess(), addr, btrap.data(),
                                    btrap.size());
-        system.CPU().ClearInstructionCache();
+        system.CPU().InvalidateCacheRange(addr, btrap.size());
+    } else {
+        // Make the CPU access the watched memory through the memory callbacks, which check the
+        // watchpoints
+        system.Memory().SetRegionWatched(*system.Kernel().GetCurrentProcess(), addr, len, true);
     }
     p.insert({addr, breakpoint});
 
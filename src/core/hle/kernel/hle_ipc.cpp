@@ -7,12 +7,14 @@
 #include "common/assert.h"
 #include "common/common_types.h"
 #include "core/core.h"
+#include "core/core_timing.h"
 #include "core/hle/kernel/event.h"
 #include "core/hle/kernel/handle_table.h"
 #include "core/hle/kernel/hle_ipc.h"
 #include "core/hle/kernel/ipc_debugger/recorder.h"
 #include "core/hle/kernel/kernel.h"
 #include "core/hle/kernel/process.h"
+#include "core/hle/service/function_stats.h"
 
 namespace Kernel {
 
@@ -37,11 +39,14 @@ std::shared_ptr<Event> HLERequestContext::SleepClientThread(const std::string& r
                                                             std::chrono::nanoseconds timeout,
                                                             WakeupCallback&& callback) {
     // Put the client thread to sleep until the wait event is signaled or the timeout expires.
-    thread->wakeup_callback = [context = *this,
-                               callback](ThreadWakeupReason reason, std::shared_ptr<Thread> thread,
-                                         std::shared_ptr<WaitObject> object) mutable {
+    thread->wakeup_callback = [context = *this, callback,
+                               sleep_ticks = kernel.timing.GetTicks()](
+                                  ThreadWakeupReason reason, std::shared_ptr<Thread> thread,
+                                  std::shared_ptr<WaitObject> object) mutable {
         ASSERT(thread->status == ThreadStatus::WaitHleEvent);
         callback(thread, context, reason);
+        Service::RecordFunctionEmulatedTime(context.function_stats_index,
+                                            context.kernel.timing.GetTicks() - sleep_ticks);
 
         auto& process = thread->owner_process;
         // We must copy the entire command buffer *plus* the entire static buffers area, since
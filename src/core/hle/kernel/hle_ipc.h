@@ -16,6 +16,7 @@
 #include "core/hle/ipc.h"
 #include "core/hle/kernel/object.h"
 #include "core/hle/kernel/server_session.h"
+#include "core/hle/service/function_stats.h"
 
 namespace Service {
 class ServiceFrameworkBase;
@@ -237,6 +238,11 @@ public:
     /// Reports an unimplemented function.
     void ReportUnimplemented() const;
 
+    /// Sets the function the emulated time spent sleeping in SleepClientThread is recorded for.
+    void SetFunctionStatsIndex(std::size_t index) {
+        function_stats_index = index;
+    }
+
 private:
     KernelSystem& kernel;
     std::array<u32, IPC::COMMAND_BUFFER_LENGTH> cmd_buf;
@@ -248,6 +254,7 @@ private:
     std::array<std::vector<u8>, IPC::MAX_STATIC_BUFFERS> static_buffers;
     // The mapped buffers will be created when the IPC request is translated
     boost::container::small_vector<MappedBuffer, 8> request_mapped_buffers;
+    std::size_t function_stats_index = Service::UNTRACKED_FUNCTION;
 };
 
 } // namespace Kernel
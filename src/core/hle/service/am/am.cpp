@@ -6,8 +6,10 @@
 #include <cinttypes>
 #include <cstddef>
 #include <cstring>
+#include <future>
 #include <cryptopp/aes.h>
 #include <cryptopp/modes.h>
+#include <cryptopp/sha.h>
 #include <fmt/format.h>
 #include "common/file_util.h"
 #include "common/logging/log.h"
@@ -43,6 +45,11 @@ constexpr u8 VARIATION_SYSTEM = 0x02;
 constexpr u32 TID_HIGH_UPDATE = 0x0004000E;
 constexpr u32 TID_HIGH_DLC = 0x0004008C;
 
+// Returned when a content doesn't match its hash in the title metadata
+constexpr ResultCode ERROR_CONTENT_HASH_MISMATCH(ErrorDescription::InvalidSection, ErrorModule::AM,
+                                                 ErrorSummary::WrongArgument,
+                                                 ErrorLevel::Permanent);
+
 struct TitleInfo {
     u64_le tid;
     u64_le size;
@@ -77,13 +84,23 @@ struct TicketInfo {
 
 static_assert(sizeof(TicketInfo) == 0x18, "Ticket info structure size is wrong");
 
-class CIAFile::DecryptionState {
+class CIAFile::ContentState {
 public:
-    std::vector<CryptoPP::CBC_Mode<CryptoPP::AES>::Decryption> content;
+    std::vector<CryptoPP::CBC_Mode<CryptoPP::AES>::Decryption> decryption;
+    std::vector<CryptoPP::SHA256> hash;
+
+    // Output files are kept open for the whole install instead of being reopened for every write
+    std::vector<FileUtil::IOFile> files;
+
+    // Scratch buffer reused across writes for decrypting content data
+    std::vector<u8> buffer;
+
+    // Set when a content doesn't match its hash in the title metadata
+    bool hash_mismatch = false;
 };
 
 CIAFile::CIAFile(Service::FS::MediaType media_type)
-    : media_type(media_type), decryption_state(std::make_unique<DecryptionState>()) {}
+    : media_type(media_type), content_state(std::make_unique<ContentState>()) {}
 
 CIAFile::~CIAFile() {
     Close();
@@ -133,12 +150,14 @@ ResultCode CIAFile::WriteTitleMetadata() {
 
     auto content_count = container.GetTitleMetadata().GetContentCount();
     content_written.resize(content_count);
+    content_state->hash.resize(content_count);
+    content_state->files.resize(content_count);
 
     if (auto title_key = container.GetTicket().GetTitleKey()) {
-        decryption_state->content.resize(content_count);
+        content_state->decryption.resize(content_count);
         for (std::size_t i = 0; i < content_count; ++i) {
             auto ctr = tmd.GetContentCTRByIndex(i);
-            decryption_state->content[i].SetKeyWithIV(title_key->data(), title_key->size(),
+            content_state->decryption[i].SetKeyWithIV(title_key->data(), title_key->size(),
                                                       ctr.data());
         }
     }
@@ -149,6 +168,10 @@ ResultCode CIAFile::WriteTitleMetadata() {
 }
 
 ResultVal<std::size_t> CIAFile::WriteContentData(u64 offset, std::size_t length, const u8* buffer) {
+    if (content_state->hash_mismatch) {
+        return ERROR_CONTENT_HASH_MISMATCH;
+    }
+
     // Data is not being buffered, so we have to keep track of how much of each
     // <ID>.app has been written since we might get a written buffer which
     // contains multiple .app contents or only part of a larger .app's contents.
@@ -174,28 +197,47 @@ ResultVal<std::size_t> CIAFile::WriteContentData(u64 offset, std::size_t length,
 
             // Since the incoming TMD has already been written, we can use
             // GetTitleContentPath to get the content paths to write to.
-            FileSys::TitleMetadata tmd = container.GetTitleMetadata();
-            FileUtil::IOFile file(GetTitleContentPath(media_type, tmd.GetTitleID(), i, is_update),
-                                  content_written[i] ? "ab" : "wb");
-
+            const FileSys::TitleMetadata& tmd = container.GetTitleMetadata();
+            FileUtil::IOFile& file = content_state->files[i];
             if (!file.IsOpen()) {
-                return FileSys::ERROR_INSUFFICIENT_SPACE;
-            }
+                file = FileUtil::IOFile(
+                    GetTitleContentPath(media_type, tmd.GetTitleID(), i, is_update),
+                    content_written[i] ? "ab" : "wb");
 
-            std::vector<u8> temp(buffer + (range_min - offset),
-                                 buffer + (range_min - offset) + available_to_write);
+                if (!file.IsOpen()) {
+                    return FileSys::ERROR_INSUFFICIENT_SPACE;
+                }
+            }
 
+            const u8* content_data = buffer + (range_min - offset);
             if ((tmd.GetContentTypeByIndex(i) & FileSys::TMDContentTypeFlag::Encrypted) != 0) {
-                decryption_state->content[i].ProcessData(temp.data(), temp.data(), temp.size());
+                std::vector<u8>& decrypted = content_state->buffer;
+                decrypted.resize(available_to_write);
+                content_state->decryption[i].ProcessData(decrypted.data(), content_data,
+                                                         decrypted.size());
+                content_data = decrypted.data();
             }
 
-            file.WriteBytes(temp.data(), temp.size());
+            content_state->hash[i].Update(content_data, available_to_write);
+            file.WriteBytes(content_data, available_to_write);
 
             // Keep tabs on how much of this content ID has been written so new
             // range_min values can be calculated.
             content_written[i] += available_to_write;
             LOG_DEBUG(Service_AM, "Wrote {:x} to content {}, total {:x}", available_to_write, i,
                       content_written[i]);
+
+            if (content_written[i] == size) {
+                file.Close();
+
+                std::array<u8, CryptoPP::SHA256::DIGESTSIZE> hash;
+                content_state->hash[i].Final(hash.data());
+                if (hash != tmd.GetContentHashByIndex(i)) {
+                    LOG_ERROR(Service_AM, "Content {} hash doesn't match the title metadata", i);
+                    content_state->hash_mismatch = true;
+                    return ERROR_CONTENT_HASH_MISMATCH;
+                }
+            }
         }
     }
 
@@ -287,6 +329,21 @@ bool CIAFile::SetSize(u64 size) const {
 }
 
 bool CIAFile::Close() const {
+    // Don't commit corrupted contents. Everything this install wrote is deleted, including the
+    // title metadata, so the title isn't detected as installed.
+    if (content_state->hash_mismatch) {
+        LOG_ERROR(Service_AM, "CIA contents are corrupted, aborting install...");
+        const FileSys::TitleMetadata& tmd = container.GetTitleMetadata();
+        for (std::size_t i = 0; i < tmd.GetContentCount(); i++) {
+            content_state->files[i].Close();
+            if (content_written[i] != 0) {
+                FileUtil::Delete(GetTitleContentPath(media_type, tmd.GetTitleID(), i, is_update));
+            }
+        }
+        FileUtil::Delete(GetTitleMetadataPath(media_type, tmd.GetTitleID(), is_update));
+        return false;
+    }
+
     bool complete = true;
     for (std::size_t i = 0; i < container.GetTitleMetadata().GetContentCount(); i++) {
         if (content_written[i] < container.GetContentSize(static_cast<u16>(i))) {
@@ -297,6 +354,9 @@ bool CIAFile::Close() const {
     // Install aborted
     if (!complete) {
         LOG_ERROR(Service_AM, "CIAFile closed prematurely, aborting install...");
+        for (FileUtil::IOFile& file : content_state->files) {
+            file.Close();
+        }
         FileUtil::DeleteDir(GetTitlePath(media_type, container.GetTitleMetadata().GetTitleID()));
         return true;
     }
@@ -368,15 +428,40 @@ InstallStatus InstallCIA(const std::string& path,
             return InstallStatus::ErrorFailedToOpenFile;
         }
 
-        std::array<u8, 0x10000> buffer;
+        // Reading the next chunk from disk is overlapped with decrypting, hashing and writing the
+        // current one, alternating between two buffers.
+        constexpr std::size_t chunk_size = 0x100000;
+        std::array<std::vector<u8>, 2> buffers{std::vector<u8>(chunk_size),
+                                               std::vector<u8>(chunk_size)};
+        const auto read_chunk = [&file](std::vector<u8>& buffer) {
+            return file.ReadBytes(buffer.data(), buffer.size());
+        };
+
+        const std::size_t file_size = file.GetSize();
+        std::size_t current_buffer = 0;
+        std::future<std::size_t> next_read =
+            std::async(std::launch::async, read_chunk, std::ref(buffers[current_buffer]));
+
         std::size_t total_bytes_read = 0;
-        while (total_bytes_read != file.GetSize()) {
-            std::size_t bytes_read = file.ReadBytes(buffer.data(), buffer.size());
+        while (total_bytes_read != file_size) {
+            std::size_t bytes_read = next_read.get();
+            if (bytes_read == 0) {
+                LOG_ERROR(Service_AM, "Failed to read CIA file {}", path);
+                return InstallStatus::ErrorAborted;
+            }
+
+            const std::vector<u8>& buffer = buffers[current_buffer];
+            current_buffer ^= 1;
+            if (total_bytes_read + bytes_read != file_size) {
+                next_read =
+                    std::async(std::launch::async, read_chunk, std::ref(buffers[current_buffer]));
+            }
+
             auto result = install_file.Write(static_cast<u64>(total_bytes_read), bytes_read, true,
-                                             static_cast<u8*>(buffer.data()));
+                                             buffer.data());
 
             if (update_callback) {
-                update_callback(total_bytes_read, file.GetSize());
+                update_callback(total_bytes_read, file_size);
             }
             if (result.Failed()) {
                 LOG_ERROR(Service_AM, "CIA file installation aborted with error code {:08x}",
@@ -385,7 +470,9 @@ InstallStatus InstallCIA(const std::string& path,
             }
             total_bytes_read += bytes_read;
         }
-        install_file.Close();
+        if (!install_file.Close()) {
+            return InstallStatus::ErrorAborted;
+        }
 
         LOG_INFO(Service_AM, "Installed {} successfully.", path);
         return InstallStatus::Success;
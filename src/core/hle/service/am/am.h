@@ -92,8 +92,9 @@ private:
     std::vector<u64> content_written;
     Service::FS::MediaType media_type;
 
-    class DecryptionState;
-    std::unique_ptr<DecryptionState> decryption_state;
+    // Per-content decryption, hashing and output file state
+    class ContentState;
+    std::unique_ptr<ContentState> content_state;
 };
 
 /**
@@ -0,0 +1,145 @@
+// Copyright 2020 vvctre project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <utility>
+#include <vector>
+#include <fmt/format.h>
+#include "common/file_util.h"
+#include "common/logging/log.h"
+#include "core/hle/service/function_stats.h"
+
+namespace Service {
+
+namespace {
+
+std::array<FunctionStats, MAX_TRACKED_FUNCTIONS> functions;
+std::atomic<std::size_t> function_count{0};
+
+std::mutex registration_mutex;
+std::map<std::pair<std::string, u32>, std::size_t> function_indices;
+
+void Add(std::atomic<u64>& counter, u64 value) {
+    counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+}
+
+std::size_t GetHistogramBucket(u64 host_time) {
+    std::size_t bucket = 0;
+    for (u64 limit = 1000; host_time >= limit && bucket < FUNCTION_HISTOGRAM_BUCKETS - 1;
+         limit <<= 1) {
+        ++bucket;
+    }
+    return bucket;
+}
+
+} // Anonymous namespace
+
+std::size_t RegisterFunction(std::string_view service, const char* name, u32 header) {
+    std::lock_guard lock{registration_mutex};
+
+    const auto key = std::make_pair(std::string(service), header);
+    if (const auto itr = function_indices.find(key); itr != function_indices.end()) {
+        return itr->second;
+    }
+
+    const std::size_t index = function_count.load(std::memory_order_relaxed);
+    if (index == MAX_TRACKED_FUNCTIONS) {
+        LOG_WARNING(Service, "Too many functions, not keeping statistics of {} {}", service,
+                    name);
+        return UNTRACKED_FUNCTION;
+    }
+
+    FunctionStats& stats = functions[index];
+    stats.service = key.first;
+    stats.name = name;
+    stats.header = header;
+
+    function_indices.emplace(key, index);
+    function_count.store(index + 1, std::memory_order_release);
+    return index;
+}
+
+std::size_t GetFunctionCount() {
+    return function_count.load(std::memory_order_acquire);
+}
+
+FunctionStats& GetFunctionStats(std::size_t index) {
+    return functions[index];
+}
+
+void RecordFunctionCall(std::size_t index, u64 host_time, u64 emulated_time) {
+    if (index == UNTRACKED_FUNCTION) {
+        return;
+    }
+
+    FunctionStats& stats = functions[index];
+    Add(stats.calls, 1);
+    Add(stats.host_time, host_time);
+    Add(stats.emulated_time, emulated_time);
+    Add(stats.histogram[GetHistogramBucket(host_time)], 1);
+}
+
+void RecordFunctionEmulatedTime(std::size_t index, u64 emulated_time) {
+    if (index != UNTRACKED_FUNCTION) {
+        Add(functions[index].emulated_time, emulated_time);
+    }
+}
+
+void ResetFunctionStats() {
+    const std::size_t count = GetFunctionCount();
+    for (std::size_t i = 0; i < count; ++i) {
+        FunctionStats& stats = functions[i];
+        stats.calls = 0;
+        stats.host_time = 0;
+        stats.emulated_time = 0;
+        for (std::atomic<u64>& bucket : stats.histogram) {
+            bucket = 0;
+        }
+    }
+}
+
+bool DumpFunctionStats(const std::string& path) {
+    FileUtil::IOFile file(path, "w");
+    if (!file.IsOpen()) {
+        LOG_ERROR(Service, "Failed to open {}", path);
+        return false;
+    }
+
+    // Sort a copy of the host times, the emulation thread can update them while this runs
+    std::vector<std::pair<u64, std::size_t>> order;
+    const std::size_t count = GetFunctionCount();
+    for (std::size_t i = 0; i < count; ++i) {
+        if (functions[i].calls != 0) {
+            order.emplace_back(functions[i].host_time.load(), i);
+        }
+    }
+    std::sort(order.begin(), order.end(), std::greater<>());
+
+    std::string header = "Service,Function,Header,Calls,Host Time (ns),Emulated Time (ticks)";
+    for (std::size_t i = 0; i < FUNCTION_HISTOGRAM_BUCKETS - 1; ++i) {
+        header += fmt::format(",< {} us", 1 << i);
+    }
+    header += fmt::format(",>= {} us\n", 1 << (FUNCTION_HISTOGRAM_BUCKETS - 2));
+    file.WriteString(header);
+
+    for (const auto& [host_time, index] : order) {
+        const FunctionStats& stats = functions[index];
+        std::string line =
+            fmt::format("{},{},0x{:08X},{},{},{}", stats.service, stats.name, stats.header,
+                        stats.calls.load(), host_time, stats.emulated_time.load());
+        for (const std::atomic<u64>& bucket : stats.histogram) {
+            line += fmt::format(",{}", bucket.load());
+        }
+        line += '\n';
+        file.WriteString(line);
+    }
+
+    LOG_INFO(Service, "Wrote the statistics of {} functions to {}", order.size(), path);
+    return true;
+}
+
+} // namespace Service
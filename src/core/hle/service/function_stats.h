@@ -0,0 +1,69 @@
+// Copyright 2020 vvctre project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include "common/common_types.h"
+
+namespace Service {
+
+/// Maximum number of service functions statistics are kept for
+constexpr std::size_t MAX_TRACKED_FUNCTIONS = 4096;
+
+/// Number of host time histogram buckets. Bucket 0 counts calls that took less than 1 µs, each
+/// following bucket doubles the limit, and the last one counts everything slower.
+constexpr std::size_t FUNCTION_HISTOGRAM_BUCKETS = 16;
+
+/// Index returned by RegisterFunction when the table is full
+constexpr std::size_t UNTRACKED_FUNCTION = MAX_TRACKED_FUNCTIONS;
+
+/**
+ * Statistics of the requests handled by a HLE service function.
+ * The counters are only written by the emulation thread, so they are updated with relaxed loads and
+ * stores and can be read from any thread.
+ */
+struct FunctionStats {
+    std::string service;
+    const char* name = nullptr;
+    u32 header = 0;
+
+    std::atomic<u64> calls{0};
+    std::atomic<u64> host_time{0};     ///< Nanoseconds
+    std::atomic<u64> emulated_time{0}; ///< CPU ticks until the reply was written
+    std::array<std::atomic<u64>, FUNCTION_HISTOGRAM_BUCKETS> histogram{};
+};
+
+/**
+ * Gets the index of the statistics of a function, adding them if this is the first service with
+ * this name registering it.
+ * @return the index, or UNTRACKED_FUNCTION if the table is full
+ */
+std::size_t RegisterFunction(std::string_view service, const char* name, u32 header);
+
+/// Gets the number of registered functions
+std::size_t GetFunctionCount();
+
+FunctionStats& GetFunctionStats(std::size_t index);
+
+/// Records a call of a registered function
+void RecordFunctionCall(std::size_t index, u64 host_time, u64 emulated_time);
+
+/// Adds the emulated time a request took after its handler put the client thread to sleep
+void RecordFunctionEmulatedTime(std::size_t index, u64 emulated_time);
+
+/// Resets the counters of every function
+void ResetFunctionStats();
+
+/**
+ * Writes the statistics of every function that was called to a CSV file, slowest first.
+ * @return whether the file was written
+ */
+bool DumpFunctionStats(const std::string& path);
+
+} // namespace Service
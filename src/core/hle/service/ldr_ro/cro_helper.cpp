@@ -2,6 +2,8 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
+#include <set>
 #include "common/alignment.h"
 #include "common/logging/log.h"
 #include "common/scope_exit.h"
@@ -48,6 +50,37 @@ const std::array<CROHelper::HeaderField, 4> CROHelper::FIX_BARRIERS{{
     Fix3Barrier,
 }};
 
+namespace {
+
+/// Tracks the pages of guest memory patched by a run of relocations, so that the CPU cache is
+/// invalidated once per run of consecutive pages instead of once per relocated word. Relocations
+/// usually patch both the text and data segments, and the pages between them are left alone.
+class RelocatedPages {
+public:
+    void Add(VAddr address) {
+        pages.insert(address >> Memory::PAGE_BITS);
+        pages.insert((address + sizeof(u32) - 1) >> Memory::PAGE_BITS);
+    }
+
+    void Invalidate(ARM_Interface& cpu) const {
+        auto it = pages.begin();
+        while (it != pages.end()) {
+            const VAddr first = *it;
+            VAddr last = first;
+            while (++it != pages.end() && *it == last + 1) {
+                last = *it;
+            }
+            cpu.InvalidateCacheRange(first << Memory::PAGE_BITS,
+                                     (last - first + 1) << Memory::PAGE_BITS);
+        }
+    }
+
+private:
+    std::set<VAddr> pages;
+};
+
+} // Anonymous namespace
+
 VAddr CROHelper::SegmentTagToAddress(SegmentTag segment_tag) const {
     u32 segment_num = GetField(SegmentNum);
 
@@ -72,11 +105,9 @@ ResultCode CROHelper::ApplyRelocation(VAddr target_address, RelocationType reloc
     case RelocationType::AbsoluteAddress:
     case RelocationType::AbsoluteAddress2:
         memory.Write32(target_address, symbol_address + addend);
-        cpu.InvalidateCacheRange(target_address, sizeof(u32));
         break;
     case RelocationType::RelativeAddress:
         memory.Write32(target_address, symbol_address + addend - target_future_address);
-        cpu.InvalidateCacheRange(target_address, sizeof(u32));
         break;
     case RelocationType::ThumbBranch:
     case RelocationType::ArmBranch:
@@ -99,7 +130,6 @@ ResultCode CROHelper::ClearRelocation(VAddr target_address, RelocationType reloc
     case RelocationType::AbsoluteAddress2:
     case RelocationType::RelativeAddress:
         memory.Write32(target_address, 0);
-        cpu.InvalidateCacheRange(target_address, sizeof(u32));
         break;
     case RelocationType::ThumbBranch:
     case RelocationType::ArmBranch:
@@ -118,6 +148,9 @@ ResultCode CROHelper::ApplyRelocationBatch(VAddr batch, u32 symbol_address, bool
     if (symbol_address == 0 && !reset)
         return CROFormatError(0x10);
 
+    RelocatedPages relocated;
+    SCOPE_EXIT({ relocated.Invalidate(cpu); });
+
     VAddr relocation_address = batch;
     while (true) {
         RelocationEntry relocation;
@@ -130,6 +163,7 @@ ResultCode CROHelper::ApplyRelocationBatch(VAddr batch, u32 symbol_address, bool
 
         ResultCode result = ApplyRelocation(relocation_target, relocation.type, relocation.addend,
                                             symbol_address, relocation_target);
+        relocated.Add(relocation_target);
         if (result.IsError()) {
             LOG_ERROR(Service_LDR, "Error applying relocation {:08X}", result.raw);
             return result;
@@ -148,50 +182,35 @@ ResultCode CROHelper::ApplyRelocationBatch(VAddr batch, u32 symbol_address, bool
     return RESULT_SUCCESS;
 }
 
-VAddr CROHelper::FindExportNamedSymbol(const std::string& name) const {
+std::unordered_map<std::string, VAddr> CROHelper::BuildExportNamedSymbolMap() const {
+    std::unordered_map<std::string, VAddr> symbols;
     if (!GetField(ExportTreeNum))
-        return 0;
-
-    std::size_t len = name.size();
-    ExportTreeEntry entry;
-    GetEntry(memory, 0, entry);
-    ExportTreeEntry::Child next;
-    next.raw = entry.left.raw;
-    u32 found_id;
-
-    while (true) {
-        GetEntry(memory, next.next_index, entry);
-
-        if (next.is_end) {
-            found_id = entry.export_table_index;
-            break;
-        }
-
-        u16 test_byte = entry.test_bit >> 3;
-        u16 test_bit_in_byte = entry.test_bit & 7;
-
-        if (test_byte >= len) {
-            next.raw = entry.left.raw;
-        } else if ((name[test_byte] >> test_bit_in_byte) & 1) {
-            next.raw = entry.right.raw;
-        } else {
-            next.raw = entry.left.raw;
-        }
-    }
+        return symbols;
 
+    u32 export_strings_size = GetField(ExportStringsSize);
     u32 export_named_symbol_num = GetField(ExportNamedSymbolNum);
+    symbols.reserve(export_named_symbol_num);
+    for (u32 i = 0; i < export_named_symbol_num; ++i) {
+        ExportNamedSymbolEntry entry;
+        GetEntry(memory, i, entry);
+        symbols.emplace(memory.ReadCString(entry.name_offset, export_strings_size),
+                        SegmentTagToAddress(entry.symbol_position));
+    }
 
-    if (found_id >= export_named_symbol_num)
-        return 0;
+    return symbols;
+}
 
-    u32 export_strings_size = GetField(ExportStringsSize);
-    ExportNamedSymbolEntry symbol_entry;
-    GetEntry(memory, found_id, symbol_entry);
+VAddr CROHelper::FindExportNamedSymbol(const std::string& name) const {
+    auto module_symbols = export_cache.find(module_address);
+    if (module_symbols == export_cache.end()) {
+        module_symbols = export_cache.emplace(module_address, BuildExportNamedSymbolMap()).first;
+    }
 
-    if (memory.ReadCString(symbol_entry.name_offset, export_strings_size) != name)
+    auto symbol = module_symbols->second.find(name);
+    if (symbol == module_symbols->second.end())
         return 0;
 
-    return SegmentTagToAddress(symbol_entry.symbol_position);
+    return symbol->second;
 }
 
 ResultCode CROHelper::RebaseHeader(u32 cro_size) {
@@ -481,6 +500,9 @@ ResultCode CROHelper::ResetExternalRelocations() {
         return CROFormatError(0x12);
     }
 
+    RelocatedPages relocated;
+    SCOPE_EXIT({ relocated.Invalidate(cpu); });
+
     bool batch_begin = true;
     for (u32 i = 0; i < external_relocation_num; ++i) {
         GetEntry(memory, i, relocation);
@@ -492,6 +514,7 @@ ResultCode CROHelper::ResetExternalRelocations() {
 
         ResultCode result = ApplyRelocation(relocation_target, relocation.type, relocation.addend,
                                             unresolved_symbol, relocation_target);
+        relocated.Add(relocation_target);
         if (result.IsError()) {
             LOG_ERROR(Service_LDR, "Error applying relocation {:08X}", result.raw);
             return result;
@@ -514,6 +537,9 @@ ResultCode CROHelper::ClearExternalRelocations() {
     u32 external_relocation_num = GetField(ExternalRelocationNum);
     ExternalRelocationEntry relocation;
 
+    RelocatedPages relocated;
+    SCOPE_EXIT({ relocated.Invalidate(cpu); });
+
     bool batch_begin = true;
     for (u32 i = 0; i < external_relocation_num; ++i) {
         GetEntry(memory, i, relocation);
@@ -524,6 +550,7 @@ ResultCode CROHelper::ClearExternalRelocations() {
         }
 
         ResultCode result = ClearRelocation(relocation_target, relocation.type);
+        relocated.Add(relocation_target);
         if (result.IsError()) {
             LOG_ERROR(Service_LDR, "Error clearing relocation {:08X}", result.raw);
             return result;
@@ -548,7 +575,7 @@ ResultCode CROHelper::ApplyStaticAnonymousSymbolToCRS(VAddr crs_address) {
         static_relocation_table_offset +
         GetField(StaticRelocationNum) * sizeof(StaticRelocationEntry);
 
-    CROHelper crs(crs_address, process, memory, cpu);
+    CROHelper crs(crs_address, process, memory, cpu, export_cache);
     u32 offset_export_num = GetField(StaticAnonymousSymbolNum);
     LOG_INFO(Service_LDR, "CRO \"{}\" exports {} static anonymous symbols", ModuleName(),
              offset_export_num);
@@ -577,6 +604,9 @@ ResultCode CROHelper::ApplyStaticAnonymousSymbolToCRS(VAddr crs_address) {
 ResultCode CROHelper::ApplyInternalRelocations(u32 old_data_segment_address) {
     u32 segment_num = GetField(SegmentNum);
     u32 internal_relocation_num = GetField(InternalRelocationNum);
+    RelocatedPages relocated;
+    SCOPE_EXIT({ relocated.Invalidate(cpu); });
+
     for (u32 i = 0; i < internal_relocation_num; ++i) {
         InternalRelocationEntry relocation;
         GetEntry(memory, i, relocation);
@@ -607,6 +637,7 @@ ResultCode CROHelper::ApplyInternalRelocations(u32 old_data_segment_address) {
                   symbol_segment.offset);
         ResultCode result = ApplyRelocation(target_address, relocation.type, relocation.addend,
                                             symbol_segment.offset, target_addressB);
+        relocated.Add(target_address);
         if (result.IsError()) {
             LOG_ERROR(Service_LDR, "Error applying relocation {:08X}", result.raw);
             return result;
@@ -617,6 +648,9 @@ ResultCode CROHelper::ApplyInternalRelocations(u32 old_data_segment_address) {
 
 ResultCode CROHelper::ClearInternalRelocations() {
     u32 internal_relocation_num = GetField(InternalRelocationNum);
+    RelocatedPages relocated;
+    SCOPE_EXIT({ relocated.Invalidate(cpu); });
+
     for (u32 i = 0; i < internal_relocation_num; ++i) {
         InternalRelocationEntry relocation;
         GetEntry(memory, i, relocation);
@@ -627,6 +661,7 @@ ResultCode CROHelper::ClearInternalRelocations() {
         }
 
         ResultCode result = ClearRelocation(target_address, relocation.type);
+        relocated.Add(target_address);
         if (result.IsError()) {
             LOG_ERROR(Service_LDR, "Error clearing relocation {:08X}", result.raw);
             return result;
@@ -758,10 +793,10 @@ ResultCode CROHelper::ApplyImportNamedSymbol(VAddr crs_address) {
                          sizeof(ExternalRelocationEntry));
 
         if (!relocation_entry.is_batch_resolved) {
+            std::string symbol_name = memory.ReadCString(entry.name_offset, import_strings_size);
             ResultCode result = ForEachAutoLinkCRO(
-                process, memory, cpu, crs_address, [&](CROHelper source) -> ResultVal<bool> {
-                    std::string symbol_name =
-                        memory.ReadCString(entry.name_offset, import_strings_size);
+                process, memory, cpu, export_cache, crs_address,
+                [&](CROHelper source) -> ResultVal<bool> {
                     u32 symbol_address = source.FindExportNamedSymbol(symbol_name);
 
                     if (symbol_address != 0) {
@@ -861,7 +896,8 @@ ResultCode CROHelper::ApplyModuleImport(VAddr crs_address) {
         std::string want_cro_name = memory.ReadCString(entry.name_offset, import_strings_size);
 
         ResultCode result = ForEachAutoLinkCRO(
-            process, memory, cpu, crs_address, [&](CROHelper source) -> ResultVal<bool> {
+            process, memory, cpu, export_cache, crs_address,
+            [&](CROHelper source) -> ResultVal<bool> {
                 if (want_cro_name == source.ModuleName()) {
                     LOG_INFO(Service_LDR, "CRO \"{}\" imports {} indexed symbols from \"{}\"",
                              ModuleName(), entry.import_indexed_symbol_num, source.ModuleName());
@@ -1071,7 +1107,8 @@ ResultCode CROHelper::ApplyExitRelocations(VAddr crs_address) {
 
         if (memory.ReadCString(entry.name_offset, import_strings_size) == "__aeabi_atexit") {
             ResultCode result = ForEachAutoLinkCRO(
-                process, memory, cpu, crs_address, [&](CROHelper source) -> ResultVal<bool> {
+                process, memory, cpu, export_cache, crs_address,
+                [&](CROHelper source) -> ResultVal<bool> {
                     u32 symbol_address = source.FindExportNamedSymbol("nnroAeabiAtexit_");
 
                     if (symbol_address != 0) {
@@ -1119,6 +1156,7 @@ static ResultCode VerifyStringTableLength(Memory::MemorySystem& memory, VAddr ad
 ResultCode CROHelper::Rebase(VAddr crs_address, u32 cro_size, VAddr data_segment_addresss,
                              u32 data_segment_size, VAddr bss_segment_address, u32 bss_segment_size,
                              bool is_crs) {
+    export_cache.erase(module_address);
 
     ResultCode result = RebaseHeader(cro_size);
     if (result.IsError()) {
@@ -1225,6 +1263,8 @@ ResultCode CROHelper::Rebase(VAddr crs_address, u32 cro_size, VAddr data_segment
 }
 
 void CROHelper::Unrebase(bool is_crs) {
+    export_cache.erase(module_address);
+
     UnrebaseImportAnonymousSymbolTable();
     UnrebaseImportIndexedSymbolTable();
     UnrebaseImportNamedSymbolTable();
@@ -1301,7 +1341,7 @@ ResultCode CROHelper::Link(VAddr crs_address, bool link_on_load_bug_fix) {
     }
 
     // Exports symbols to other modules
-    result = ForEachAutoLinkCRO(process, memory, cpu, crs_address,
+    result = ForEachAutoLinkCRO(process, memory, cpu, export_cache, crs_address,
                                 [this](CROHelper target) -> ResultVal<bool> {
                                     ResultCode result = ApplyExportNamedSymbol(target);
                                     if (result.IsError())
@@ -1346,7 +1386,7 @@ ResultCode CROHelper::Unlink(VAddr crs_address) {
 
     // Resets all symbols in other modules imported from this module
     // Note: the RO service seems only searching in auto-link modules
-    result = ForEachAutoLinkCRO(process, memory, cpu, crs_address,
+    result = ForEachAutoLinkCRO(process, memory, cpu, export_cache, crs_address,
                                 [this](CROHelper target) -> ResultVal<bool> {
                                     ResultCode result = ResetExportNamedSymbol(target);
                                     if (result.IsError())
@@ -1387,13 +1427,14 @@ void CROHelper::InitCRS() {
 }
 
 void CROHelper::Register(VAddr crs_address, bool auto_link) {
-    CROHelper crs(crs_address, process, memory, cpu);
-    CROHelper head(auto_link ? crs.NextModule() : crs.PreviousModule(), process, memory, cpu);
+    CROHelper crs(crs_address, process, memory, cpu, export_cache);
+    CROHelper head(auto_link ? crs.NextModule() : crs.PreviousModule(), process, memory, cpu,
+                   export_cache);
 
     if (head.module_address) {
         // there are already CROs registered
         // register as the new tail
-        CROHelper tail(head.PreviousModule(), process, memory, cpu);
+        CROHelper tail(head.PreviousModule(), process, memory, cpu, export_cache);
 
         // link with the old tail
         ASSERT(tail.NextModule() == 0);
@@ -1419,11 +1460,11 @@ void CROHelper::Register(VAddr crs_address, bool auto_link) {
 }
 
 void CROHelper::Unregister(VAddr crs_address) {
-    CROHelper crs(crs_address, process, memory, cpu);
-    CROHelper next_head(crs.NextModule(), process, memory, cpu);
-    CROHelper previous_head(crs.PreviousModule(), process, memory, cpu);
-    CROHelper next(NextModule(), process, memory, cpu);
-    CROHelper previous(PreviousModule(), process, memory, cpu);
+    CROHelper crs(crs_address, process, memory, cpu, export_cache);
+    CROHelper next_head(crs.NextModule(), process, memory, cpu, export_cache);
+    CROHelper previous_head(crs.PreviousModule(), process, memory, cpu, export_cache);
+    CROHelper next(NextModule(), process, memory, cpu, export_cache);
+    CROHelper previous(PreviousModule(), process, memory, cpu, export_cache);
 
     if (module_address == next_head.module_address ||
         module_address == previous_head.module_address) {
@@ -5,7 +5,9 @@
 #pragma once
 
 #include <array>
+#include <string>
 #include <tuple>
+#include <unordered_map>
 #include "common/common_types.h"
 #include "common/swap.h"
 #include "core/hle/result.h"
@@ -29,13 +31,18 @@ namespace Service::LDR {
 static constexpr u32 CRO_HEADER_SIZE = 0x138;
 static constexpr u32 CRO_HASH_SIZE = 0x80;
 
+/// Host-side copy of the named export table of each loaded module, keyed by module address, so
+/// that resolving an import doesn't walk the export tree of every module in guest memory.
+using CROExportCache = std::unordered_map<VAddr, std::unordered_map<std::string, VAddr>>;
+
 /// Represents a loaded module (CRO) with interfaces manipulating it.
 class CROHelper final {
 public:
     // TODO (wwylele): pass in the process handle for memory access
     explicit CROHelper(VAddr cro_address, Kernel::Process& process, Memory::MemorySystem& memory,
-                       ARM_Interface& cpu)
-        : module_address(cro_address), process(process), memory(memory), cpu(cpu) {}
+                       ARM_Interface& cpu, CROExportCache& export_cache)
+        : module_address(cro_address), process(process), memory(memory), cpu(cpu),
+          export_cache(export_cache) {}
 
     std::string ModuleName() const {
         return memory.ReadCString(GetField(ModuleNameOffset), GetField(ModuleNameSize));
@@ -146,6 +153,7 @@ private:
     Kernel::Process& process;   ///< the owner process of this module
     Memory::MemorySystem& memory;
     ARM_Interface& cpu;
+    CROExportCache& export_cache; ///< the export lookup tables shared by all modules of a client
 
     /**
      * Each item in this enum represents a u32 field in the header begin from address+0x80,
@@ -475,11 +483,11 @@ private:
      */
     template <typename FunctionObject>
     static ResultCode ForEachAutoLinkCRO(Kernel::Process& process, Memory::MemorySystem& memory,
-                                         ARM_Interface& cpu, VAddr crs_address,
-                                         FunctionObject func) {
+                                         ARM_Interface& cpu, CROExportCache& export_cache,
+                                         VAddr crs_address, FunctionObject func) {
         VAddr current = crs_address;
         while (current != 0) {
-            CROHelper cro(current, process, memory, cpu);
+            CROHelper cro(current, process, memory, cpu, export_cache);
             CASCADE_RESULT(bool next, func(cro));
             if (!next)
                 break;
@@ -520,7 +528,14 @@ private:
     ResultCode ApplyRelocationBatch(VAddr batch, u32 symbol_address, bool reset = false);
 
     /**
-     * Finds an exported named symbol in this module.
+     * Reads the named export table of this module into a host-side map from name to address.
+     * @return the map of exported named symbols; empty if the module has no export tree.
+     */
+    std::unordered_map<std::string, VAddr> BuildExportNamedSymbolMap() const;
+
+    /**
+     * Finds an exported named symbol in this module. The export table is read into the export
+     * cache on first use and kept until the module is rebased or unrebased again.
      * @param name the name of the symbol to find
      * @return VAddr the virtual address of the symbol; 0 if not found.
      */
@@ -122,7 +122,7 @@ void RO::Initialize(Kernel::HLERequestContext& ctx) {
         return;
     }
 
-    CROHelper crs(crs_address, *process, system.Memory(), system.CPU());
+    CROHelper crs(crs_address, *process, system.Memory(), system.CPU(), slot->export_cache);
     crs.InitCRS();
 
     result = crs.Rebase(0, crs_size, 0, 0, 0, 0, true);
@@ -256,7 +256,7 @@ void RO::LoadCRO(Kernel::HLERequestContext& ctx, bool link_on_load_bug_fix) {
         return;
     }
 
-    CROHelper cro(cro_address, *process, system.Memory(), system.CPU());
+    CROHelper cro(cro_address, *process, system.Memory(), system.CPU(), slot->export_cache);
 
     result = cro.VerifyHash(cro_size, crr_address);
     if (result.IsError()) {
@@ -338,11 +338,11 @@ void RO::UnloadCRO(Kernel::HLERequestContext& ctx) {
     LOG_DEBUG(Service_LDR, "called, cro_address=0x{:08X}, zero={}, cro_buffer_ptr=0x{:08X}",
               cro_address, zero, cro_buffer_ptr);
 
-    CROHelper cro(cro_address, *process, system.Memory(), system.CPU());
+    ClientSlot* slot = GetSessionData(ctx.Session());
+    CROHelper cro(cro_address, *process, system.Memory(), system.CPU(), slot->export_cache);
 
     IPC::RequestBuilder rb = rp.MakeBuilder(1, 0);
 
-    ClientSlot* slot = GetSessionData(ctx.Session());
     if (slot->loaded_crs == 0) {
         LOG_ERROR(Service_LDR, "Not initialized");
         rb.Push(ERROR_NOT_INITIALIZED);
@@ -405,11 +405,11 @@ void RO::LinkCRO(Kernel::HLERequestContext& ctx) {
 
     LOG_DEBUG(Service_LDR, "called, cro_address=0x{:08X}", cro_address);
 
-    CROHelper cro(cro_address, *process, system.Memory(), system.CPU());
+    ClientSlot* slot = GetSessionData(ctx.Session());
+    CROHelper cro(cro_address, *process, system.Memory(), system.CPU(), slot->export_cache);
 
     IPC::RequestBuilder rb = rp.MakeBuilder(1, 0);
 
-    ClientSlot* slot = GetSessionData(ctx.Session());
     if (slot->loaded_crs == 0) {
         LOG_ERROR(Service_LDR, "Not initialized");
         rb.Push(ERROR_NOT_INITIALIZED);
@@ -445,11 +445,11 @@ void RO::UnlinkCRO(Kernel::HLERequestContext& ctx) {
 
     LOG_DEBUG(Service_LDR, "called, cro_address=0x{:08X}", cro_address);
 
-    CROHelper cro(cro_address, *process, system.Memory(), system.CPU());
+    ClientSlot* slot = GetSessionData(ctx.Session());
+    CROHelper cro(cro_address, *process, system.Memory(), system.CPU(), slot->export_cache);
 
     IPC::RequestBuilder rb = rp.MakeBuilder(1, 0);
 
-    ClientSlot* slot = GetSessionData(ctx.Session());
     if (slot->loaded_crs == 0) {
         LOG_ERROR(Service_LDR, "Not initialized");
         rb.Push(ERROR_NOT_INITIALIZED);
@@ -494,7 +494,7 @@ void RO::Shutdown(Kernel::HLERequestContext& ctx) {
         return;
     }
 
-    CROHelper crs(slot->loaded_crs, *process, system.Memory(), system.CPU());
+    CROHelper crs(slot->loaded_crs, *process, system.Memory(), system.CPU(), slot->export_cache);
     crs.Unrebase(true);
 
     ResultCode result = RESULT_SUCCESS;
@@ -506,6 +506,7 @@ void RO::Shutdown(Kernel::HLERequestContext& ctx) {
     }
 
     slot->loaded_crs = 0;
+    slot->export_cache.clear();
     rb.Push(result);
 }
 
@@ -79,10 +79,10 @@ std::list<Network::WifiPacket> NWM_UDS::GetReceivedBeacons(const MacAddress& sen
 
 /// Sends a WifiPacket to the room we're currently connected to.
 void SendPacket(Network::WifiPacket& packet) {
-    if (std::shared_ptr<Network::RoomMember> room_member = Network::GetRoomMember().lock()) {
-        if (room_member->GetState() == Network::RoomMember::State::Joined) {
-            packet.transmitter_address = room_member->GetMacAddress();
-            room_member->SendWifiPacket(packet);
+    if (std::shared_ptr<Network::WifiTransport> transport = Network::GetWifiTransport().lock()) {
+        if (transport->IsJoined()) {
+            packet.transmitter_address = transport->GetMacAddress();
+            transport->SendWifiPacket(packet);
         }
     }
 }
@@ -567,8 +567,8 @@ boost::optional<Network::MacAddress> NWM_UDS::GetNodeMacAddress(u16 dest_node_id
 void NWM_UDS::Shutdown(Kernel::HLERequestContext& ctx) {
     IPC::RequestParser rp(ctx, 0x03, 0, 0);
 
-    if (std::shared_ptr<Network::RoomMember> room_member = Network::GetRoomMember().lock())
-        room_member->Unbind(wifi_packet_received);
+    if (std::shared_ptr<Network::WifiTransport> transport = Network::GetWifiTransport().lock())
+        transport->UnbindOnWifiPacketReceived(wifi_packet_received);
 
     for (auto bind_node : channel_data) {
         bind_node.second.event->Signal();
@@ -659,8 +659,8 @@ ResultVal<std::shared_ptr<Kernel::Event>> NWM_UDS::Initialize(
     recv_buffer_memory = std::move(sharedmem);
     ASSERT_MSG(recv_buffer_memory->GetSize() == sharedmem_size, "Invalid shared memory size.");
 
-    if (std::shared_ptr<Network::RoomMember> room_member = Network::GetRoomMember().lock()) {
-        wifi_packet_received = room_member->BindOnWifiPacketReceived(
+    if (std::shared_ptr<Network::WifiTransport> transport = Network::GetWifiTransport().lock()) {
+        wifi_packet_received = transport->BindOnWifiPacketReceived(
             [this](const Network::WifiPacket& packet) { OnWifiPacketReceived(packet); });
     } else {
         LOG_ERROR(Service_NWM, "Network isn't initalized");
@@ -891,9 +891,10 @@ ResultCode NWM_UDS::BeginHostingNetwork(const u8* network_info_buffer,
         // Notify the application that the first node was set.
         connection_status.changed_nodes |= 1;
 
-        if (std::shared_ptr<Network::RoomMember> room_member = Network::GetRoomMember().lock()) {
-            if (room_member->IsConnected()) {
-                network_info.host_mac_address = room_member->GetMacAddress();
+        if (std::shared_ptr<Network::WifiTransport> transport =
+                Network::GetWifiTransport().lock()) {
+            if (transport->IsJoined()) {
+                network_info.host_mac_address = transport->GetMacAddress();
             } else {
                 network_info.host_mac_address = {{0x0, 0x0, 0x0, 0x0, 0x0, 0x0}};
             }
@@ -1475,9 +1476,9 @@ NWM_UDS::NWM_UDS(Core::System& system) : ServiceFramework("nwm::UDS"), system(sy
     // Keep the Nintendo 3DS MAC header and randomly generate the last 3 bytes
     rng.GenerateBlock(static_cast<CryptoPP::byte*>(mac.data() + 3), 3);
 
-    if (std::shared_ptr<Network::RoomMember> room_member = Network::GetRoomMember().lock()) {
-        if (room_member->IsConnected()) {
-            mac = room_member->GetMacAddress();
+    if (std::shared_ptr<Network::WifiTransport> transport = Network::GetWifiTransport().lock()) {
+        if (transport->IsJoined()) {
+            mac = transport->GetMacAddress();
         }
     }
 
@@ -1486,8 +1487,8 @@ NWM_UDS::NWM_UDS(Core::System& system) : ServiceFramework("nwm::UDS"), system(sy
 }
 
 NWM_UDS::~NWM_UDS() {
-    if (std::shared_ptr<Network::RoomMember> room_member = Network::GetRoomMember().lock()) {
-        room_member->Unbind(wifi_packet_received);
+    if (std::shared_ptr<Network::WifiTransport> transport = Network::GetWifiTransport().lock()) {
+        transport->UnbindOnWifiPacketReceived(wifi_packet_received);
     }
 
     system.CoreTiming().UnscheduleEvent(beacon_broadcast_event, 0);
@@ -274,7 +274,7 @@ private:
     Core::TimingEventType* beacon_broadcast_event;
 
     // Callback identifier for the OnWifiPacketReceived event.
-    Network::RoomMember::CallbackHandle<Network::WifiPacket> wifi_packet_received;
+    Network::WifiTransport::PacketCallbackHandle wifi_packet_received;
 
     // Mutex to synchronize access to the connection status between the emulation thread and the
     // network thread.
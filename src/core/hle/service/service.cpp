@@ -3,10 +3,13 @@
 // Refer to the license.txt file included.
 
 #include <algorithm>
+#include <chrono>
 #include <fmt/format.h>
 #include "common/assert.h"
 #include "common/logging/log.h"
+#include "common/profiler.h"
 #include "core/core.h"
+#include "core/core_timing.h"
 #include "core/hle/ipc.h"
 #include "core/hle/kernel/client_port.h"
 #include "core/hle/kernel/handle_table.h"
@@ -137,7 +140,10 @@ void ServiceFrameworkBase::RegisterHandlersBase(const FunctionInfoBase* function
     handlers.reserve(handlers.size() + n);
     for (std::size_t i = 0; i < n; ++i) {
         // Usually this array is sorted by id already, so hint to insert at the end
-        handlers.emplace_hint(handlers.cend(), functions[i].expected_header, functions[i]);
+        auto itr =
+            handlers.emplace_hint(handlers.cend(), functions[i].expected_header, functions[i]);
+        itr->second.stats_index =
+            RegisterFunction(service_name, functions[i].name, functions[i].expected_header);
     }
 }
 
@@ -173,7 +179,20 @@ void ServiceFrameworkBase::HandleSyncRequest(Kernel::HLERequestContext& context)
 
     LOG_TRACE(Service, "{}",
               MakeFunctionString(info->name, GetServiceName(), context.CommandBuffer()));
+    Common::Profiler::ScopedTimer timer{"HLE", info->name};
+
+    Core::Timing& timing = Core::System::GetInstance().CoreTiming();
+    const u64 start_ticks = timing.GetTicks();
+    const auto start_time = std::chrono::steady_clock::now();
+
+    context.SetFunctionStatsIndex(info->stats_index);
     handler_invoker(this, info->handler_callback, context);
+
+    RecordFunctionCall(info->stats_index,
+                       std::chrono::duration_cast<std::chrono::nanoseconds>(
+                           std::chrono::steady_clock::now() - start_time)
+                           .count(),
+                       timing.GetTicks() - start_ticks);
 }
 
 std::string ServiceFrameworkBase::GetFunctionName(u32 header) const {
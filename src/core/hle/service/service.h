@@ -13,6 +13,7 @@
 #include "common/common_types.h"
 #include "core/hle/kernel/hle_ipc.h"
 #include "core/hle/kernel/object.h"
+#include "core/hle/service/function_stats.h"
 #include "core/hle/service/sm/sm.h"
 
 namespace Core {
@@ -80,6 +81,7 @@ private:
         u32 expected_header;
         HandlerFnP<ServiceFrameworkBase> handler_callback;
         const char* name;
+        std::size_t stats_index = UNTRACKED_FUNCTION; ///< Set when the handler is registered
     };
 
     using InvokerFn = void(ServiceFrameworkBase* object, HandlerFnP<ServiceFrameworkBase> member,
@@ -5,6 +5,7 @@
 #include <cstring>
 #include <numeric>
 #include <type_traits>
+#include <vector>
 #include "common/alignment.h"
 #include "common/color.h"
 #include "common/common_types.h"
@@ -16,6 +17,7 @@
 #include "core/hw/gpu.h"
 #include "core/hw/hw.h"
 #include "core/memory.h"
+#include "core/movie.h"
 #include "core/settings.h"
 #include "video_core/command_processor.h"
 #include "video_core/rasterizer_interface.h"
@@ -45,26 +47,126 @@ inline void Read(T& var, const u32 raw_addr) {
     var = g_regs[addr / 4];
 }
 
-static Common::Vec4<u8> DecodePixel(Regs::PixelFormat input_format, const u8* src_pixel) {
-    switch (input_format) {
-    case Regs::PixelFormat::RGBA8:
+template <Regs::PixelFormat input_format>
+static Common::Vec4<u8> DecodePixel(const u8* src_pixel) {
+    if constexpr (input_format == Regs::PixelFormat::RGBA8) {
         return Color::DecodeRGBA8(src_pixel);
-
-    case Regs::PixelFormat::RGB8:
+    } else if constexpr (input_format == Regs::PixelFormat::RGB8) {
         return Color::DecodeRGB8(src_pixel);
-
-    case Regs::PixelFormat::RGB565:
+    } else if constexpr (input_format == Regs::PixelFormat::RGB565) {
         return Color::DecodeRGB565(src_pixel);
-
-    case Regs::PixelFormat::RGB5A1:
+    } else if constexpr (input_format == Regs::PixelFormat::RGB5A1) {
         return Color::DecodeRGB5A1(src_pixel);
-
-    case Regs::PixelFormat::RGBA4:
+    } else {
         return Color::DecodeRGBA4(src_pixel);
+    }
+}
 
-    default:
-        LOG_ERROR(HW_GPU, "Unknown source framebuffer format {:x}", static_cast<u32>(input_format));
-        return {0, 0, 0, 0};
+template <Regs::PixelFormat output_format>
+static void EncodePixel(const Common::Vec4<u8>& color, u8* dst_pixel) {
+    if constexpr (output_format == Regs::PixelFormat::RGBA8) {
+        Color::EncodeRGBA8(color, dst_pixel);
+    } else if constexpr (output_format == Regs::PixelFormat::RGB8) {
+        Color::EncodeRGB8(color, dst_pixel);
+    } else if constexpr (output_format == Regs::PixelFormat::RGB565) {
+        Color::EncodeRGB565(color, dst_pixel);
+    } else if constexpr (output_format == Regs::PixelFormat::RGB5A1) {
+        Color::EncodeRGB5A1(color, dst_pixel);
+    } else {
+        Color::EncodeRGBA4(color, dst_pixel);
+    }
+}
+
+static bool IsValidPixelFormat(Regs::PixelFormat format) {
+    return format <= Regs::PixelFormat::RGBA4;
+}
+
+/**
+ * Byte offsets of every pixel touched by a display transfer, split into a per-column and a
+ * per-row component. Both linear and Morton (8x8 tiled) addressing are separable in x and y, so
+ * precomputing the columns once turns the per-pixel offset calculation into two table lookups.
+ */
+struct TransferOffsets {
+    std::vector<u32> src_columns;
+    std::vector<u32> dst_columns;
+    std::vector<u32> src_rows;
+    std::vector<u32> dst_rows;
+};
+
+static u32 ColumnOffset(u32 x, u32 bytes_per_pixel, bool tiled) {
+    return tiled ? VideoCore::GetMortonOffset(x, 0, bytes_per_pixel) : x * bytes_per_pixel;
+}
+
+static u32 RowOffset(u32 y, u32 width, u32 bytes_per_pixel, bool tiled) {
+    if (!tiled) {
+        return y * width * bytes_per_pixel;
+    }
+
+    const u32 coarse_y = y & ~7;
+    return VideoCore::GetMortonOffset(0, y, bytes_per_pixel) + coarse_y * width * bytes_per_pixel;
+}
+
+/// Converts all the pixels of a display transfer. The formats are template parameters so that
+/// their dispatch happens once per transfer instead of once per pixel.
+template <Regs::PixelFormat input_format, Regs::PixelFormat output_format>
+static void DisplayTransferPixels(const Regs::DisplayTransferConfig& config,
+                                  const TransferOffsets& offsets, const u8* src_pointer,
+                                  u8* dst_pointer) {
+    const u32 src_bytes_per_pixel = GPU::Regs::BytesPerPixel(input_format);
+    const std::size_t output_width = offsets.dst_columns.size();
+    const std::size_t output_height = offsets.dst_rows.size();
+
+    for (std::size_t y = 0; y < output_height; ++y) {
+        const u8* src_row = src_pointer + offsets.src_rows[y];
+        u8* dst_row = dst_pointer + offsets.dst_rows[y];
+
+        for (std::size_t x = 0; x < output_width; ++x) {
+            const u8* src_pixel = src_row + offsets.src_columns[x];
+
+            Common::Vec4<u8> src_color = DecodePixel<input_format>(src_pixel);
+            if (config.scaling == config.ScaleX) {
+                Common::Vec4<u8> pixel = DecodePixel<input_format>(src_pixel + src_bytes_per_pixel);
+                src_color = ((src_color + pixel) / 2).Cast<u8>();
+            } else if (config.scaling == config.ScaleXY) {
+                Common::Vec4<u8> pixel1 =
+                    DecodePixel<input_format>(src_pixel + 1 * src_bytes_per_pixel);
+                Common::Vec4<u8> pixel2 =
+                    DecodePixel<input_format>(src_pixel + 2 * src_bytes_per_pixel);
+                Common::Vec4<u8> pixel3 =
+                    DecodePixel<input_format>(src_pixel + 3 * src_bytes_per_pixel);
+                src_color = (((src_color + pixel1) + (pixel2 + pixel3)) / 4).Cast<u8>();
+            }
+
+            EncodePixel<output_format>(src_color, dst_row + offsets.dst_columns[x]);
+        }
+    }
+}
+
+template <Regs::PixelFormat input_format>
+static void DisplayTransferPixels(const Regs::DisplayTransferConfig& config,
+                                  const TransferOffsets& offsets, const u8* src_pointer,
+                                  u8* dst_pointer) {
+    switch (config.output_format) {
+    case Regs::PixelFormat::RGBA8:
+        DisplayTransferPixels<input_format, Regs::PixelFormat::RGBA8>(config, offsets, src_pointer,
+                                                                      dst_pointer);
+        break;
+    case Regs::PixelFormat::RGB8:
+        DisplayTransferPixels<input_format, Regs::PixelFormat::RGB8>(config, offsets, src_pointer,
+                                                                     dst_pointer);
+        break;
+    case Regs::PixelFormat::RGB565:
+        DisplayTransferPixels<input_format, Regs::PixelFormat::RGB565>(config, offsets,
+                                                                       src_pointer, dst_pointer);
+        break;
+    case Regs::PixelFormat::RGB5A1:
+        DisplayTransferPixels<input_format, Regs::PixelFormat::RGB5A1>(config, offsets,
+                                                                       src_pointer, dst_pointer);
+        break;
+    case Regs::PixelFormat::RGBA4:
+        DisplayTransferPixels<input_format, Regs::PixelFormat::RGBA4>(config, offsets, src_pointer,
+                                                                      dst_pointer);
+        break;
     }
 }
 
@@ -175,6 +277,18 @@ static void DisplayTransfer(const Regs::DisplayTransferConfig& config) {
         return;
     }
 
+    if (!IsValidPixelFormat(config.input_format)) {
+        LOG_ERROR(HW_GPU, "Unknown source framebuffer format {:x}",
+                  static_cast<u32>(config.input_format.Value()));
+        return;
+    }
+
+    if (!IsValidPixelFormat(config.output_format)) {
+        LOG_ERROR(HW_GPU, "Unknown destination framebuffer format {:x}",
+                  static_cast<u32>(config.output_format.Value()));
+        return;
+    }
+
     int horizontal_scale = config.scaling != config.NoScale ? 1 : 0;
     int vertical_scale = config.scaling == config.ScaleXY ? 1 : 0;
 
@@ -188,112 +302,63 @@ static void DisplayTransfer(const Regs::DisplayTransferConfig& config) {
     Memory::RasterizerFlushRegion(config.GetPhysicalInputAddress(), input_size);
     Memory::RasterizerInvalidateRegion(config.GetPhysicalOutputAddress(), output_size);
 
-    for (u32 y = 0; y < output_height; ++y) {
-        for (u32 x = 0; x < output_width; ++x) {
-            Common::Vec4<u8> src_color;
-
-            // Calculate the [x,y] position of the input image
-            // based on the current output position and the scale
-            u32 input_x = x << horizontal_scale;
-            u32 input_y = y << vertical_scale;
-
-            u32 output_y;
-            if (config.flip_vertically) {
-                // Flip the y value of the output data,
-                // we do this after calculating the [x,y] position of the input image
-                // to account for the scaling options.
-                output_y = output_height - y - 1;
-            } else {
-                output_y = y;
-            }
-
-            u32 dst_bytes_per_pixel = GPU::Regs::BytesPerPixel(config.output_format);
-            u32 src_bytes_per_pixel = GPU::Regs::BytesPerPixel(config.input_format);
-            u32 src_offset;
-            u32 dst_offset;
-
-            if (config.input_linear) {
-                if (!config.dont_swizzle) {
-                    // Interpret the input as linear and the output as tiled
-                    u32 coarse_y = output_y & ~7;
-                    u32 stride = output_width * dst_bytes_per_pixel;
-
-                    src_offset = (input_x + input_y * config.input_width) * src_bytes_per_pixel;
-                    dst_offset = VideoCore::GetMortonOffset(x, output_y, dst_bytes_per_pixel) +
-                                 coarse_y * stride;
-                } else {
-                    // Both input and output are linear
-                    src_offset = (input_x + input_y * config.input_width) * src_bytes_per_pixel;
-                    dst_offset = (x + output_y * output_width) * dst_bytes_per_pixel;
-                }
-            } else {
-                if (!config.dont_swizzle) {
-                    // Interpret the input as tiled and the output as linear
-                    u32 coarse_y = input_y & ~7;
-                    u32 stride = config.input_width * src_bytes_per_pixel;
-
-                    src_offset = VideoCore::GetMortonOffset(input_x, input_y, src_bytes_per_pixel) +
-                                 coarse_y * stride;
-                    dst_offset = (x + output_y * output_width) * dst_bytes_per_pixel;
-                } else {
-                    // Both input and output are tiled
-                    u32 out_coarse_y = output_y & ~7;
-                    u32 out_stride = output_width * dst_bytes_per_pixel;
-
-                    u32 in_coarse_y = input_y & ~7;
-                    u32 in_stride = config.input_width * src_bytes_per_pixel;
-
-                    src_offset = VideoCore::GetMortonOffset(input_x, input_y, src_bytes_per_pixel) +
-                                 in_coarse_y * in_stride;
-                    dst_offset = VideoCore::GetMortonOffset(x, output_y, dst_bytes_per_pixel) +
-                                 out_coarse_y * out_stride;
-                }
-            }
+    u32 dst_bytes_per_pixel = GPU::Regs::BytesPerPixel(config.output_format);
+    u32 src_bytes_per_pixel = GPU::Regs::BytesPerPixel(config.input_format);
 
-            const u8* src_pixel = src_pointer + src_offset;
-            src_color = DecodePixel(config.input_format, src_pixel);
-            if (config.scaling == config.ScaleX) {
-                Common::Vec4<u8> pixel =
-                    DecodePixel(config.input_format, src_pixel + src_bytes_per_pixel);
-                src_color = ((src_color + pixel) / 2).Cast<u8>();
-            } else if (config.scaling == config.ScaleXY) {
-                Common::Vec4<u8> pixel1 =
-                    DecodePixel(config.input_format, src_pixel + 1 * src_bytes_per_pixel);
-                Common::Vec4<u8> pixel2 =
-                    DecodePixel(config.input_format, src_pixel + 2 * src_bytes_per_pixel);
-                Common::Vec4<u8> pixel3 =
-                    DecodePixel(config.input_format, src_pixel + 3 * src_bytes_per_pixel);
-                src_color = (((src_color + pixel1) + (pixel2 + pixel3)) / 4).Cast<u8>();
-            }
+    // Tiled input is always converted to linear output and vice versa, unless dont_swizzle is set,
+    // in which case the tiling is kept as is.
+    const bool src_tiled = !config.input_linear;
+    const bool dst_tiled = config.input_linear != config.dont_swizzle;
 
-            u8* dst_pixel = dst_pointer + dst_offset;
-            switch (config.output_format) {
-            case Regs::PixelFormat::RGBA8:
-                Color::EncodeRGBA8(src_color, dst_pixel);
-                break;
+    TransferOffsets offsets;
+    offsets.src_columns.resize(output_width);
+    offsets.dst_columns.resize(output_width);
+    offsets.src_rows.resize(output_height);
+    offsets.dst_rows.resize(output_height);
 
-            case Regs::PixelFormat::RGB8:
-                Color::EncodeRGB8(src_color, dst_pixel);
-                break;
+    for (u32 x = 0; x < output_width; ++x) {
+        // Calculate the x position of the input image based on the current output position and
+        // the scale
+        u32 input_x = x << horizontal_scale;
 
-            case Regs::PixelFormat::RGB565:
-                Color::EncodeRGB565(src_color, dst_pixel);
-                break;
+        offsets.src_columns[x] = ColumnOffset(input_x, src_bytes_per_pixel, src_tiled);
+        offsets.dst_columns[x] = ColumnOffset(x, dst_bytes_per_pixel, dst_tiled);
+    }
 
-            case Regs::PixelFormat::RGB5A1:
-                Color::EncodeRGB5A1(src_color, dst_pixel);
-                break;
+    for (u32 y = 0; y < output_height; ++y) {
+        u32 input_y = y << vertical_scale;
+
+        u32 output_y;
+        if (config.flip_vertically) {
+            // Flip the y value of the output data,
+            // we do this after calculating the [x,y] position of the input image
+            // to account for the scaling options.
+            output_y = output_height - y - 1;
+        } else {
+            output_y = y;
+        }
 
-            case Regs::PixelFormat::RGBA4:
-                Color::EncodeRGBA4(src_color, dst_pixel);
-                break;
+        offsets.src_rows[y] =
+            RowOffset(input_y, config.input_width, src_bytes_per_pixel, src_tiled);
+        offsets.dst_rows[y] = RowOffset(output_y, output_width, dst_bytes_per_pixel, dst_tiled);
+    }
 
-            default:
-                LOG_ERROR(HW_GPU, "Unknown destination framebuffer format {:x}",
-                          static_cast<u32>(config.output_format.Value()));
-                break;
-            }
-        }
+    switch (config.input_format) {
+    case Regs::PixelFormat::RGBA8:
+        DisplayTransferPixels<Regs::PixelFormat::RGBA8>(config, offsets, src_pointer, dst_pointer);
+        break;
+    case Regs::PixelFormat::RGB8:
+        DisplayTransferPixels<Regs::PixelFormat::RGB8>(config, offsets, src_pointer, dst_pointer);
+        break;
+    case Regs::PixelFormat::RGB565:
+        DisplayTransferPixels<Regs::PixelFormat::RGB565>(config, offsets, src_pointer, dst_pointer);
+        break;
+    case Regs::PixelFormat::RGB5A1:
+        DisplayTransferPixels<Regs::PixelFormat::RGB5A1>(config, offsets, src_pointer, dst_pointer);
+        break;
+    case Regs::PixelFormat::RGBA4:
+        DisplayTransferPixels<Regs::PixelFormat::RGBA4>(config, offsets, src_pointer, dst_pointer);
+        break;
     }
 }
 
@@ -482,6 +547,8 @@ template void Write<u8>(u32 addr, const u8 data);
 
 /// Update hardware
 static void VBlankCallback(u64 userdata, s64 cycles_late) {
+    Core::Movie::GetInstance().HandleFrame();
+
     VideoCore::g_renderer->SwapBuffers();
 
     // Signal to GSP that GPU interrupt has occurred
@@ -23,59 +23,105 @@ static const std::size_t MAX_TILES = 1024 / 8;
 static const std::size_t TILE_SIZE = 8 * 8;
 using ImageTile = std::array<u32, TILE_SIZE>;
 
-/// Converts a image strip from the source YUV format into individual 8x8 RGB32 tiles.
-static void ConvertYUVToRGB(InputFormat input_format, const u8* input_Y, const u8* input_U,
-                            const u8* input_V, ImageTile output[], unsigned int width,
-                            unsigned int height, const CoefficientSet& coefficients) {
+/// Converts a single line of an image strip from the source YUV format into the corresponding
+/// line of each 8x8 RGB32 tile. The input format is a template parameter so that its dispatch
+/// happens once per strip instead of once per pixel.
+template <InputFormat input_format>
+static void ConvertYUVLineToRGB(const u8* input_Y, const u8* input_U, const u8* input_V,
+                                ImageTile output[], unsigned int width, unsigned int y,
+                                const CoefficientSet& coefficients) {
+    constexpr bool is_interleaved = input_format == InputFormat::YUYV422_Interleaved;
+    constexpr bool is_420 = input_format == InputFormat::YUV420_Indiv8 ||
+                            input_format == InputFormat::YUV420_Indiv16;
+
+    const u8* line_Y = input_Y + y * width * (is_interleaved ? 2 : 1);
+    const u8* line_U = nullptr;
+    const u8* line_V = nullptr;
+    if constexpr (!is_interleaved) {
+        // Chroma is subsampled horizontally for all planar formats, and also vertically for 4:2:0
+        const unsigned int chroma_line = is_420 ? y / 2 : y;
+        line_U = input_U + chroma_line * width / 2;
+        line_V = input_V + chroma_line * width / 2;
+    }
 
-    for (unsigned int y = 0; y < height; ++y) {
-        for (unsigned int x = 0; x < width; ++x) {
-            s32 Y = 0;
-            s32 U = 0;
-            s32 V = 0;
-            switch (input_format) {
-            case InputFormat::YUV422_Indiv8:
-            case InputFormat::YUV422_Indiv16:
-                Y = input_Y[y * width + x];
-                U = input_U[(y * width + x) / 2];
-                V = input_V[(y * width + x) / 2];
-                break;
-            case InputFormat::YUV420_Indiv8:
-            case InputFormat::YUV420_Indiv16:
-                Y = input_Y[y * width + x];
-                U = input_U[((y / 2) * width + x) / 2];
-                V = input_V[((y / 2) * width + x) / 2];
-                break;
-            case InputFormat::YUYV422_Interleaved:
-                Y = input_Y[(y * width + x) * 2];
-                U = input_Y[(y * width + (x / 2) * 2) * 2 + 1];
-                V = input_Y[(y * width + (x / 2) * 2) * 2 + 3];
-                break;
+    // Copied to locals so the compiler can keep them in registers across the whole line
+    const s32 c0 = coefficients[0];
+    const s32 c1 = coefficients[1];
+    const s32 c2 = coefficients[2];
+    const s32 c3 = coefficients[3];
+    const s32 c4 = coefficients[4];
+    const s32 c5 = coefficients[5];
+    const s32 c6 = coefficients[6];
+    const s32 c7 = coefficients[7];
+
+    for (unsigned int tile = 0; tile < width / 8; ++tile) {
+        u32* out = &output[tile][y * 8];
+
+        for (unsigned int tile_x = 0; tile_x < 8; ++tile_x) {
+            const unsigned int x = tile * 8 + tile_x;
+
+            s32 Y, U, V;
+            if constexpr (is_interleaved) {
+                Y = line_Y[x * 2];
+                U = line_Y[(x / 2) * 4 + 1];
+                V = line_Y[(x / 2) * 4 + 3];
+            } else {
+                Y = line_Y[x];
+                U = line_U[x / 2];
+                V = line_V[x / 2];
             }
 
             // This conversion process is bit-exact with hardware, as far as could be tested.
-            auto& c = coefficients;
-            s32 cY = c[0] * Y;
+            const s32 cY = c0 * Y;
 
-            s32 r = cY + c[1] * V;
-            s32 g = cY - c[2] * V - c[3] * U;
-            s32 b = cY + c[4] * U;
+            s32 r = cY + c1 * V;
+            s32 g = cY - c2 * V - c3 * U;
+            s32 b = cY + c4 * U;
 
             const s32 rounding_offset = 0x18;
-            r = (r >> 3) + c[5] + rounding_offset;
-            g = (g >> 3) + c[6] + rounding_offset;
-            b = (b >> 3) + c[7] + rounding_offset;
-
-            unsigned int tile = x / 8;
-            unsigned int tile_x = x % 8;
-            u32* out = &output[tile][y * 8 + tile_x];
-            *out = ((u32)std::clamp(r >> 5, 0, 0xFF) << 24) |
-                   ((u32)std::clamp(g >> 5, 0, 0xFF) << 16) |
-                   ((u32)std::clamp(b >> 5, 0, 0xFF) << 8);
+            r = (r >> 3) + c5 + rounding_offset;
+            g = (g >> 3) + c6 + rounding_offset;
+            b = (b >> 3) + c7 + rounding_offset;
+
+            out[tile_x] = ((u32)std::clamp(r >> 5, 0, 0xFF) << 24) |
+                          ((u32)std::clamp(g >> 5, 0, 0xFF) << 16) |
+                          ((u32)std::clamp(b >> 5, 0, 0xFF) << 8);
         }
     }
 }
 
+/// Converts a image strip from the source YUV format into individual 8x8 RGB32 tiles.
+template <InputFormat input_format>
+static void ConvertYUVToRGB(const u8* input_Y, const u8* input_U, const u8* input_V,
+                            ImageTile output[], unsigned int width, unsigned int height,
+                            const CoefficientSet& coefficients) {
+    for (unsigned int y = 0; y < height; ++y) {
+        ConvertYUVLineToRGB<input_format>(input_Y, input_U, input_V, output, width, y,
+                                          coefficients);
+    }
+}
+
+static void ConvertYUVToRGB(InputFormat input_format, const u8* input_Y, const u8* input_U,
+                            const u8* input_V, ImageTile output[], unsigned int width,
+                            unsigned int height, const CoefficientSet& coefficients) {
+    switch (input_format) {
+    case InputFormat::YUV422_Indiv8:
+    case InputFormat::YUV422_Indiv16:
+        ConvertYUVToRGB<InputFormat::YUV422_Indiv8>(input_Y, input_U, input_V, output, width,
+                                                    height, coefficients);
+        break;
+    case InputFormat::YUV420_Indiv8:
+    case InputFormat::YUV420_Indiv16:
+        ConvertYUVToRGB<InputFormat::YUV420_Indiv8>(input_Y, input_U, input_V, output, width,
+                                                    height, coefficients);
+        break;
+    case InputFormat::YUYV422_Interleaved:
+        ConvertYUVToRGB<InputFormat::YUYV422_Interleaved>(input_Y, input_U, input_V, output,
+                                                          width, height, coefficients);
+        break;
+    }
+}
+
 /// Simulates an incoming CDMA transfer. The N parameter is used to automatically convert 16-bit
 /// formats to 8-bit.
 template <std::size_t N>
@@ -101,9 +147,14 @@ static void ReceiveData(Memory::MemorySystem& memory, u8* output, ConversionBuff
 }
 
 /// Convert intermediate RGB32 format to the final output format while simulating an outgoing CDMA
-/// transfer.
+/// transfer. The output format is a template parameter so that its dispatch happens once per strip
+/// instead of once per pixel.
+template <OutputFormat output_format>
 static void SendData(Memory::MemorySystem& memory, const u32* input, ConversionBuffer& buf,
-                     int amount_of_data, OutputFormat output_format, u8 alpha) {
+                     int amount_of_data, u8 alpha) {
+    constexpr std::size_t bytes_per_pixel = output_format == OutputFormat::RGBA8  ? 4
+                                            : output_format == OutputFormat::RGB8 ? 3
+                                                                                  : 2;
 
     u8* output = memory.GetPointer(buf.address);
 
@@ -113,24 +164,16 @@ static void SendData(Memory::MemorySystem& memory, const u32* input, ConversionB
             u32 color = *input++;
             Common::Vec4<u8> col_vec{(u8)(color >> 24), (u8)(color >> 16), (u8)(color >> 8), alpha};
 
-            switch (output_format) {
-            case OutputFormat::RGBA8:
+            if constexpr (output_format == OutputFormat::RGBA8) {
                 Color::EncodeRGBA8(col_vec, output);
-                output += 4;
-                break;
-            case OutputFormat::RGB8:
+            } else if constexpr (output_format == OutputFormat::RGB8) {
                 Color::EncodeRGB8(col_vec, output);
-                output += 3;
-                break;
-            case OutputFormat::RGB5A1:
+            } else if constexpr (output_format == OutputFormat::RGB5A1) {
                 Color::EncodeRGB5A1(col_vec, output);
-                output += 2;
-                break;
-            case OutputFormat::RGB565:
+            } else {
                 Color::EncodeRGB565(col_vec, output);
-                output += 2;
-                break;
             }
+            output += bytes_per_pixel;
 
             amount_of_data -= 1;
         }
@@ -141,6 +184,24 @@ static void SendData(Memory::MemorySystem& memory, const u32* input, ConversionB
     }
 }
 
+static void SendData(Memory::MemorySystem& memory, const u32* input, ConversionBuffer& buf,
+                     int amount_of_data, OutputFormat output_format, u8 alpha) {
+    switch (output_format) {
+    case OutputFormat::RGBA8:
+        SendData<OutputFormat::RGBA8>(memory, input, buf, amount_of_data, alpha);
+        break;
+    case OutputFormat::RGB8:
+        SendData<OutputFormat::RGB8>(memory, input, buf, amount_of_data, alpha);
+        break;
+    case OutputFormat::RGB5A1:
+        SendData<OutputFormat::RGB5A1>(memory, input, buf, amount_of_data, alpha);
+        break;
+    case OutputFormat::RGB565:
+        SendData<OutputFormat::RGB565>(memory, input, buf, amount_of_data, alpha);
+        break;
+    }
+}
+
 static const u8 linear_lut[TILE_SIZE] = {
     // clang-format off
      0,  1,  2,  3,  4,  5,  6,  7,
@@ -323,8 +384,6 @@ void PerformConversion(Memory::MemorySystem& memory, ConversionConfiguration& cv
             break;
         }
 
-        // Note(yuriks): If additional optimization is required, input_format can be moved to a
-        // template parameter, so that its dispatch can be moved to outside the inner loop.
         ConvertYUVToRGB(cvt.input_format, input_Y, input_U, input_V, tiles.get(),
                         cvt.input_line_width, row_height, cvt.coefficients);
 
@@ -371,8 +430,6 @@ void PerformConversion(Memory::MemorySystem& memory, ConversionConfiguration& cv
             }
         }
 
-        // Note(yuriks): If additional optimization is required, output_format can be moved to a
-        // template parameter, so that its dispatch can be moved to outside the inner loop.
         SendData(memory, reinterpret_cast<u32*>(data_buffer.get()), cvt.dst, (int)row_data_size,
                  cvt.output_format, (u8)cvt.alpha);
     }
@@ -62,6 +62,10 @@ u8* PageTable::Get(VAddr vaddr) const {
     return page_ptr + vaddr;
 }
 
+u8* PageTable::GetWatched(VAddr vaddr) const {
+    return watched_pages.at(vaddr >> PAGE_BITS).backing_memory + (vaddr & PAGE_MASK);
+}
+
 void PageTable::Set(PageType page_type, VAddr vaddr, u8* backing_memory) {
     attributes[vaddr >> PAGE_BITS] = page_type;
     if (backing_memory) {
@@ -120,6 +124,10 @@ void MemorySystem::MapPages(PageTable& page_table, u32 base, u32 size, u8* memor
         if (type == PageType::Memory && impl->cache_marker.IsCached(base * PAGE_SIZE)) {
             page_table.SetRasterizerCachedMemory(base);
             impl->fastmem_mapper.Unmap(page_table, base * PAGE_SIZE, PAGE_SIZE);
+        } else if (type == PageType::Memory && page_table.watched_pages.count(base) != 0) {
+            // Keep the watchpoints on the page working
+            page_table.SetWatchedMemory(base * PAGE_SIZE, memory);
+            impl->fastmem_mapper.Unmap(page_table, base * PAGE_SIZE, PAGE_SIZE);
         } else if (memory) {
             impl->fastmem_mapper.Map(page_table, base * PAGE_SIZE, memory, PAGE_SIZE);
         } else {
@@ -191,6 +199,11 @@ T MemorySystem::Read(const VAddr vaddr) {
         std::memcpy(&value, GetPointerForRasterizerCache(vaddr), sizeof(T));
         return value;
     }
+    case PageType::Watched: {
+        T value;
+        std::memcpy(&value, impl->current_page_table->GetWatched(vaddr), sizeof(T));
+        return value;
+    }
     default:
         UNREACHABLE();
     }
@@ -218,6 +231,9 @@ void MemorySystem::Write(const VAddr vaddr, const T data) {
         std::memcpy(GetPointerForRasterizerCache(vaddr), &data, sizeof(T));
         break;
     }
+    case PageType::Watched:
+        std::memcpy(impl->current_page_table->GetWatched(vaddr), &data, sizeof(T));
+        break;
     default:
         UNREACHABLE();
     }
@@ -236,6 +252,9 @@ bool MemorySystem::IsValidVirtualAddress(const Kernel::Process& process, const V
     if (page_table.attributes[vaddr >> PAGE_BITS] == PageType::RasterizerCachedMemory)
         return true;
 
+    if (page_table.attributes[vaddr >> PAGE_BITS] == PageType::Watched)
+        return true;
+
     return false;
 }
 
@@ -249,6 +268,10 @@ u8* MemorySystem::GetPointer(const VAddr vaddr) {
         return GetPointerForRasterizerCache(vaddr);
     }
 
+    if (impl->current_page_table->attributes[vaddr >> PAGE_BITS] == PageType::Watched) {
+        return impl->current_page_table->GetWatched(vaddr);
+    }
+
     LOG_ERROR(HW_Memory, "unknown GetPointer @ 0x{:08x} at PC 0x{:08X}", vaddr,
               Core::System::GetInstance().CPU().GetPC());
     return nullptr;
@@ -355,6 +378,9 @@ void MemorySystem::RasterizerMarkRegionCached(PAddr start, u32 size, bool cached
                         page_table->SetRasterizerCachedMemory(vaddr);
                         impl->fastmem_mapper.Unmap(*page_table, vaddr, PAGE_SIZE);
                         break;
+                    case PageType::Watched:
+                        page_table->SetRasterizerCachedMemory(vaddr);
+                        break;
                     default:
                         break;
                     }
@@ -363,6 +389,10 @@ void MemorySystem::RasterizerMarkRegionCached(PAddr start, u32 size, bool cached
                     switch (page_type) {
                     case PageType::RasterizerCachedMemory: {
                         u8* ptr = GetPointerForRasterizerCache(vaddr & ~PAGE_MASK);
+                        if (page_table->watched_pages.count(vaddr >> PAGE_BITS) != 0) {
+                            page_table->SetWatchedMemory(vaddr & ~PAGE_MASK, ptr);
+                            break;
+                        }
                         page_table->SetMemory(vaddr, ptr);
                         impl->fastmem_mapper.Map(*page_table, vaddr, ptr, PAGE_SIZE);
                         break;
@@ -376,6 +406,41 @@ void MemorySystem::RasterizerMarkRegionCached(PAddr start, u32 size, bool cached
     }
 }
 
+void MemorySystem::SetRegionWatched(Kernel::Process& process, VAddr vaddr, u32 size,
+                                    bool watched) {
+    PageTable& page_table = process.vm_manager.page_table;
+    const u32 first_page = vaddr >> PAGE_BITS;
+    const u32 last_page = (vaddr + std::max(size, 1u) - 1) >> PAGE_BITS;
+
+    for (u32 page = first_page; page <= last_page; ++page) {
+        const VAddr page_vaddr = page << PAGE_BITS;
+
+        if (watched) {
+            auto [it, inserted] = page_table.watched_pages.try_emplace(page);
+            ++it->second.watchpoints;
+
+            // Pages of other types are already accessed through the memory callbacks
+            if (inserted && page_table.attributes[page] == PageType::Memory) {
+                page_table.SetWatchedMemory(page_vaddr, page_table.Get(page_vaddr));
+                impl->fastmem_mapper.Unmap(page_table, page_vaddr, PAGE_SIZE);
+            }
+        } else {
+            const auto it = page_table.watched_pages.find(page);
+            if (it == page_table.watched_pages.end() || --it->second.watchpoints != 0) {
+                continue;
+            }
+
+            u8* backing_memory = it->second.backing_memory;
+            page_table.watched_pages.erase(it);
+
+            if (page_table.attributes[page] == PageType::Watched) {
+                page_table.SetMemory(page_vaddr, backing_memory);
+                impl->fastmem_mapper.Map(page_table, page_vaddr, backing_memory, PAGE_SIZE);
+            }
+        }
+    }
+}
+
 void RasterizerFlushRegion(PAddr start, u32 size) {
     if (VideoCore::g_renderer == nullptr) {
         return;
@@ -490,6 +555,9 @@ void MemorySystem::ReadBlock(const Kernel::Process& process, const VAddr src_add
             std::memcpy(dest_buffer, GetPointerForRasterizerCache(current_vaddr), copy_amount);
             break;
         }
+        case PageType::Watched:
+            std::memcpy(dest_buffer, page_table.GetWatched(current_vaddr), copy_amount);
+            break;
         default:
             UNREACHABLE();
         }
@@ -548,6 +616,9 @@ void MemorySystem::WriteBlock(const Kernel::Process& process, const VAddr dest_a
             std::memcpy(GetPointerForRasterizerCache(current_vaddr), src_buffer, copy_amount);
             break;
         }
+        case PageType::Watched:
+            std::memcpy(page_table.GetWatched(current_vaddr), src_buffer, copy_amount);
+            break;
         default:
             UNREACHABLE();
         }
@@ -590,6 +661,9 @@ void MemorySystem::ZeroBlock(const Kernel::Process& process, const VAddr dest_ad
             std::memset(GetPointerForRasterizerCache(current_vaddr), 0, copy_amount);
             break;
         }
+        case PageType::Watched:
+            std::memset(page_table.GetWatched(current_vaddr), 0, copy_amount);
+            break;
         default:
             UNREACHABLE();
         }
@@ -639,6 +713,9 @@ void MemorySystem::CopyBlock(const Kernel::Process& dest_process,
                        copy_amount);
             break;
         }
+        case PageType::Watched:
+            WriteBlock(dest_process, dest_addr, page_table.GetWatched(current_vaddr), copy_amount);
+            break;
         default:
             UNREACHABLE();
         }
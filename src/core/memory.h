@@ -8,6 +8,7 @@
 #include <cstddef>
 #include <memory>
 #include <string>
+#include <unordered_map>
 #include <vector>
 #include "common/common_types.h"
 #include "common/fastmem_mapper.h"
@@ -51,6 +52,9 @@ enum class PageType {
     /// Page is mapped to regular memory, but also needs to check for rasterizer cache flushing and
     /// invalidation
     RasterizerCachedMemory,
+    /// Page is mapped to regular memory, but the CPU accesses it through the memory callbacks so
+    /// the GDB stub's watchpoints on it can be checked
+    Watched,
 };
 
 /**
@@ -84,9 +88,21 @@ private:
      */
     Common::FastmemRegion fastmem_base;
 
+    struct WatchedPage {
+        /// Backing memory of the page, used while its type is `Watched`
+        u8* backing_memory = nullptr;
+        u32 watchpoints = 0;
+    };
+
+    /// Pages with watchpoints on them, which keep them from being accessed directly
+    std::unordered_map<u32, WatchedPage> watched_pages;
+
     /// Get backing memory for a virtual address. May be nullptr.
     u8* Get(VAddr vaddr) const;
 
+    /// Get backing memory for a virtual address in a page of type `Watched`
+    u8* GetWatched(VAddr vaddr) const;
+
     void Set(PageType page_type, VAddr vaddr, u8* backing_memory);
 
     void SetMemory(VAddr vaddr, u8* backing_memory) {
@@ -96,6 +112,11 @@ private:
     void SetRasterizerCachedMemory(VAddr vaddr) {
         Set(PageType::RasterizerCachedMemory, vaddr, nullptr);
     }
+
+    void SetWatchedMemory(VAddr vaddr, u8* backing_memory) {
+        Set(PageType::Watched, vaddr, nullptr);
+        watched_pages[vaddr >> PAGE_BITS].backing_memory = backing_memory - (vaddr & PAGE_MASK);
+    }
 };
 
 /// Physical memory regions as seen from the ARM11
@@ -294,6 +315,13 @@ public:
      */
     void RasterizerMarkRegionCached(PAddr start, u32 size, bool cached);
 
+    /**
+     * Makes the CPU access each page touching the region through the memory callbacks instead of
+     * directly while there are watchpoints on it. Calls with watched set to false must match
+     * earlier calls with it set to true.
+     */
+    void SetRegionWatched(Kernel::Process& process, VAddr vaddr, u32 size, bool watched);
+
     /// Registers page table for rasterizer cache marking
     void RegisterPageTable(PageTable* page_table);
 
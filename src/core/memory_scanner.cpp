@@ -0,0 +1,404 @@
+// Copyright 2020 vvctre project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <thread>
+#include <type_traits>
+#ifdef ARCHITECTURE_x86_64
+#include <emmintrin.h>
+#endif
+#include "common/bit_set.h"
+#include "common/logging/log.h"
+#include "core/core.h"
+#include "core/hle/kernel/process.h"
+#include "core/memory.h"
+#include "core/memory_scanner.h"
+
+namespace Memory {
+
+namespace {
+
+/// Number of values in a word of Region::matches
+constexpr std::size_t BLOCK_VALUES = 64;
+
+/// Bytes of memory scanned by each task given to the threads
+constexpr std::size_t TASK_SIZE = 0x100000;
+
+std::size_t GetValueSize(MemoryScanner::ValueType type) {
+    switch (type) {
+    case MemoryScanner::ValueType::U8:
+        return 1;
+    case MemoryScanner::ValueType::U16:
+        return 2;
+    case MemoryScanner::ValueType::U32:
+    case MemoryScanner::ValueType::Float:
+        return 4;
+    case MemoryScanner::ValueType::U64:
+    case MemoryScanner::ValueType::Double:
+        return 8;
+    default:
+        return 0;
+    }
+}
+
+bool UsesSnapshot(MemoryScanner::Comparison comparison) {
+    return comparison == MemoryScanner::Comparison::Changed ||
+           comparison == MemoryScanner::Comparison::Unchanged ||
+           comparison == MemoryScanner::Comparison::Increased ||
+           comparison == MemoryScanner::Comparison::Decreased;
+}
+
+template <typename T>
+T Load(const u8* pointer) {
+    T value;
+    std::memcpy(&value, pointer, sizeof(T));
+    return value;
+}
+
+/// Converts a value given as bits to T
+template <typename T>
+T Decode(u64 bits) {
+    if constexpr (std::is_integral_v<T>) {
+        return static_cast<T>(bits);
+    } else {
+        using Bits = std::conditional_t<sizeof(T) == 4, u32, u64>;
+        const Bits value_bits = static_cast<Bits>(bits);
+        T value;
+        std::memcpy(&value, &value_bits, sizeof(T));
+        return value;
+    }
+}
+
+/// Compares the bits, so a NaN is unchanged if it stays the same
+template <typename T>
+bool Same(T a, T b) {
+    return std::memcmp(&a, &b, sizeof(T)) == 0;
+}
+
+/**
+ * Returns a bit for each of the BLOCK_VALUES values at memory for which predicate is true, and
+ * stores the values in snapshot for the next scan.
+ */
+template <typename T, typename Predicate>
+u64 MatchBlock(const u8* memory, u8* snapshot, Predicate predicate) {
+    u64 matches = 0;
+    for (std::size_t i = 0; i < BLOCK_VALUES; ++i) {
+        const T current = Load<T>(memory + i * sizeof(T));
+        const T previous = Load<T>(snapshot + i * sizeof(T));
+        matches |= static_cast<u64>(predicate(current, previous)) << i;
+        std::memcpy(snapshot + i * sizeof(T), &current, sizeof(T));
+    }
+    return matches;
+}
+
+#ifdef ARCHITECTURE_x86_64
+template <typename T>
+__m128i Splat(T value) {
+    if constexpr (sizeof(T) == 1) {
+        return _mm_set1_epi8(static_cast<char>(value));
+    } else if constexpr (sizeof(T) == 2) {
+        return _mm_set1_epi16(static_cast<short>(value));
+    } else {
+        return _mm_set1_epi32(static_cast<int>(value));
+    }
+}
+
+/**
+ * Compares 16 values at memory to the ones returned by load_other, which is given the offset of
+ * each 16 bytes. Returns a bit for each equal pair.
+ */
+template <typename T, typename LoadOther>
+u32 EqualMask16(const u8* memory, LoadOther load_other) {
+    const auto compare = [memory, &load_other](std::size_t offset) {
+        const __m128i values = _mm_loadu_si128(reinterpret_cast<const __m128i*>(memory + offset));
+        if constexpr (sizeof(T) == 1) {
+            return _mm_cmpeq_epi8(values, load_other(offset));
+        } else if constexpr (sizeof(T) == 2) {
+            return _mm_cmpeq_epi16(values, load_other(offset));
+        } else {
+            return _mm_cmpeq_epi32(values, load_other(offset));
+        }
+    };
+
+    // The comparison results are all ones or zeros, so packing them keeps them intact
+    if constexpr (sizeof(T) == 1) {
+        return static_cast<u32>(_mm_movemask_epi8(compare(0)));
+    } else if constexpr (sizeof(T) == 2) {
+        return static_cast<u32>(_mm_movemask_epi8(_mm_packs_epi16(compare(0), compare(16))));
+    } else {
+        const __m128i low = _mm_packs_epi32(compare(0), compare(16));
+        const __m128i high = _mm_packs_epi32(compare(32), compare(48));
+        return static_cast<u32>(_mm_movemask_epi8(_mm_packs_epi16(low, high)));
+    }
+}
+
+/// Like MatchBlock, for equality with the values returned by load_other
+template <typename T, typename LoadOther>
+u64 EqualBlock(const u8* memory, u8* snapshot, LoadOther load_other) {
+    u64 matches = 0;
+    for (std::size_t i = 0; i < BLOCK_VALUES / 16; ++i) {
+        const std::size_t group_offset = i * 16 * sizeof(T);
+        matches |= static_cast<u64>(EqualMask16<T>(memory + group_offset,
+                                                   [&](std::size_t offset) {
+                                                       return load_other(group_offset + offset);
+                                                   }))
+                   << (i * 16);
+    }
+    std::memcpy(snapshot, memory, BLOCK_VALUES * sizeof(T));
+    return matches;
+}
+#endif
+
+/**
+ * Runs match_block on the blocks that have results, or on every block in the first scan, with
+ * a thread for each CPU core.
+ * @return the number of results
+ */
+template <typename T, typename MatchBlockFunction>
+std::size_t RunScan(std::vector<MemoryScanner::Region>& regions, bool first,
+                    const MatchBlockFunction& match_block) {
+    constexpr std::size_t block_size = BLOCK_VALUES * sizeof(T);
+    constexpr std::size_t blocks_per_task = TASK_SIZE / block_size;
+
+    struct Task {
+        MemoryScanner::Region* region;
+        std::size_t first_block;
+        std::size_t last_block;
+    };
+
+    std::vector<Task> tasks;
+    for (MemoryScanner::Region& region : regions) {
+        const std::size_t block_count = region.matches.size();
+        for (std::size_t block = 0; block < block_count; block += blocks_per_task) {
+            tasks.push_back(
+                Task{&region, block, std::min(block + blocks_per_task, block_count)});
+        }
+    }
+
+    std::atomic<std::size_t> next_task{0};
+    std::atomic<std::size_t> result_count{0};
+    const auto worker = [&] {
+        std::size_t count = 0;
+        for (std::size_t i = next_task++; i < tasks.size(); i = next_task++) {
+            const Task& task = tasks[i];
+            u8* memory = task.region->memory;
+            u8* snapshot = task.region->snapshot.data();
+
+            for (std::size_t block = task.first_block; block < task.last_block; ++block) {
+                u64& matches = task.region->matches[block];
+                if (!first && matches == 0) {
+                    continue;
+                }
+
+                const std::size_t offset = block * block_size;
+                const u64 block_matches = match_block(memory + offset, snapshot + offset);
+                matches = first ? block_matches : matches & block_matches;
+                count += CountSetBits(matches);
+            }
+        }
+        result_count += count;
+    };
+
+    const std::size_t thread_count =
+        std::min<std::size_t>(std::max(std::thread::hardware_concurrency(), 1U), tasks.size());
+    std::vector<std::thread> threads;
+    for (std::size_t i = 1; i < thread_count; ++i) {
+        threads.emplace_back(worker);
+    }
+    worker();
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    return result_count;
+}
+
+template <typename T>
+std::size_t ScanValues(std::vector<MemoryScanner::Region>& regions,
+                       MemoryScanner::Comparison comparison, T value, T value2, bool first) {
+    using Comparison = MemoryScanner::Comparison;
+
+    const auto scan = [&regions, first](auto predicate) {
+        return RunScan<T>(regions, first, [&predicate](const u8* memory, u8* snapshot) {
+            return MatchBlock<T>(memory, snapshot, predicate);
+        });
+    };
+
+#ifdef ARCHITECTURE_x86_64
+    if constexpr (std::is_integral_v<T> && sizeof(T) <= 4) {
+        switch (comparison) {
+        case Comparison::Exact: {
+            const __m128i splat = Splat(value);
+            return RunScan<T>(regions, first, [splat](const u8* memory, u8* snapshot) {
+                return EqualBlock<T>(memory, snapshot, [splat](std::size_t) { return splat; });
+            });
+        }
+        case Comparison::Changed:
+        case Comparison::Unchanged: {
+            const u64 invert = comparison == Comparison::Changed ? ~0ULL : 0;
+            return RunScan<T>(regions, first, [invert](const u8* memory, u8* snapshot) {
+                return invert ^ EqualBlock<T>(memory, snapshot, [snapshot](std::size_t offset) {
+                           return _mm_loadu_si128(
+                               reinterpret_cast<const __m128i*>(snapshot + offset));
+                       });
+            });
+        }
+        default:
+            break;
+        }
+    }
+#endif
+
+    switch (comparison) {
+    case Comparison::Unknown:
+        return scan([](T, T) { return true; });
+    case Comparison::Exact:
+        return scan([value](T current, T) { return current == value; });
+    case Comparison::Range:
+        return scan(
+            [value, value2](T current, T) { return value <= current && current <= value2; });
+    case Comparison::Fuzzy:
+        return scan([value, value2](T current, T) {
+            return static_cast<T>(current >= value ? current - value : value - current) <= value2;
+        });
+    case Comparison::Changed:
+        return scan([](T current, T previous) { return !Same(current, previous); });
+    case Comparison::Unchanged:
+        return scan([](T current, T previous) { return Same(current, previous); });
+    case Comparison::Increased:
+        return scan([](T current, T previous) { return current > previous; });
+    case Comparison::Decreased:
+        return scan([](T current, T previous) { return current < previous; });
+    default:
+        LOG_ERROR(Core, "Invalid comparison {}", static_cast<u32>(comparison));
+        return 0;
+    }
+}
+
+} // Anonymous namespace
+
+MemoryScanner::MemoryScanner(Core::System& system) : system(system) {}
+
+MemoryScanner::~MemoryScanner() = default;
+
+std::size_t MemoryScanner::FirstScan(ValueType type_, Comparison comparison, u64 value,
+                                     u64 value2) {
+    if (GetValueSize(type_) == 0) {
+        LOG_ERROR(Core, "Invalid value type {}", static_cast<u32>(type_));
+        return 0;
+    }
+
+    if (UsesSnapshot(comparison)) {
+        LOG_ERROR(Core, "The first scan can't compare to a previous scan");
+        comparison = Comparison::Unknown;
+    }
+
+    type = type_;
+    regions.clear();
+
+    const std::size_t block_size = BLOCK_VALUES * GetValueSize(type);
+    for (const auto& [base, vma] : system.Kernel().GetCurrentProcess()->vm_manager.vma_map) {
+        if (vma.type != Kernel::VMAType::BackingMemory) {
+            continue;
+        }
+
+        Region& region = regions.emplace_back();
+        region.base = base;
+        region.size = vma.size;
+        region.memory = vma.backing_memory;
+        region.snapshot.resize(vma.size);
+        region.matches.resize(vma.size / block_size);
+    }
+
+    return Scan(comparison, value, value2, true);
+}
+
+std::size_t MemoryScanner::NextScan(Comparison comparison, u64 value, u64 value2) {
+    UpdateRegions();
+    return Scan(comparison, value, value2, false);
+}
+
+std::size_t MemoryScanner::GetResultCount() const {
+    return result_count;
+}
+
+std::size_t MemoryScanner::GetResults(VAddr* addresses, std::size_t max) const {
+    const u32 value_size = static_cast<u32>(GetValueSize(type));
+    std::size_t count = 0;
+
+    for (const Region& region : regions) {
+        for (std::size_t block = 0; block < region.matches.size(); ++block) {
+            for (u64 matches = region.matches[block]; matches != 0; matches &= matches - 1) {
+                if (count == max) {
+                    return count;
+                }
+
+                const std::size_t index = block * BLOCK_VALUES + LeastSignificantSetBit(matches);
+                addresses[count++] = region.base + static_cast<u32>(index) * value_size;
+            }
+        }
+    }
+
+    return count;
+}
+
+std::size_t MemoryScanner::Scan(Comparison comparison, u64 value, u64 value2, bool first) {
+    // Write back the textures rendered to the searched memory
+    for (const Region& region : regions) {
+        RasterizerFlushVirtualRegion(region.base, region.size, FlushMode::Flush);
+    }
+
+    switch (type) {
+    case ValueType::U8:
+        result_count = ScanValues<u8>(regions, comparison, Decode<u8>(value), Decode<u8>(value2),
+                                      first);
+        break;
+    case ValueType::U16:
+        result_count = ScanValues<u16>(regions, comparison, Decode<u16>(value),
+                                       Decode<u16>(value2), first);
+        break;
+    case ValueType::U32:
+        result_count = ScanValues<u32>(regions, comparison, Decode<u32>(value),
+                                       Decode<u32>(value2), first);
+        break;
+    case ValueType::U64:
+        result_count = ScanValues<u64>(regions, comparison, Decode<u64>(value),
+                                       Decode<u64>(value2), first);
+        break;
+    case ValueType::Float:
+        result_count = ScanValues<float>(regions, comparison, Decode<float>(value),
+                                         Decode<float>(value2), first);
+        break;
+    case ValueType::Double:
+        result_count = ScanValues<double>(regions, comparison, Decode<double>(value),
+                                          Decode<double>(value2), first);
+        break;
+    }
+
+    return result_count;
+}
+
+void MemoryScanner::UpdateRegions() {
+    const Kernel::VMManager& vm_manager = system.Kernel().GetCurrentProcess()->vm_manager;
+
+    regions.erase(std::remove_if(regions.begin(), regions.end(),
+                                 [&vm_manager](Region& region) {
+                                     const auto vma = vm_manager.FindVMA(region.base);
+                                     if (vma == vm_manager.vma_map.end() ||
+                                         vma->second.type != Kernel::VMAType::BackingMemory ||
+                                         vma->second.base + vma->second.size <
+                                             region.base + region.size) {
+                                         return true;
+                                     }
+
+                                     region.memory = vma->second.backing_memory +
+                                                     (region.base - vma->second.base);
+                                     return false;
+                                 }),
+                  regions.end());
+}
+
+} // namespace Memory
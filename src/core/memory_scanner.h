@@ -0,0 +1,92 @@
+// Copyright 2020 vvctre project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <vector>
+#include "common/common_types.h"
+
+namespace Core {
+class System;
+} // namespace Core
+
+namespace Memory {
+
+/**
+ * Searches the memory of the current process for values, then narrows the results with further
+ * scans, like the searches of cheat tools.
+ * Each scan compares every aligned value of the searched type against the given values or against
+ * a snapshot taken by the previous scan, splitting the work between threads.
+ */
+class MemoryScanner {
+public:
+    enum class ValueType : u32 {
+        U8,
+        U16,
+        U32,
+        U64,
+        Float,  ///< The bits of a float in the low 32 bits of the values
+        Double, ///< The bits of a double
+    };
+
+    enum class Comparison : u32 {
+        Unknown,   ///< Every value matches, to start searching for an unknown value
+        Exact,     ///< Equal to value
+        Range,     ///< Between value and value2, both inclusive
+        Fuzzy,     ///< Differs from value by at most value2
+        Changed,   ///< Differs from the previous scan
+        Unchanged, ///< Same as in the previous scan
+        Increased, ///< Greater than in the previous scan
+        Decreased, ///< Less than in the previous scan
+    };
+
+    explicit MemoryScanner(Core::System& system);
+    ~MemoryScanner();
+
+    /**
+     * Starts a new search in the memory of the current process.
+     * @return the number of results
+     */
+    std::size_t FirstScan(ValueType type, Comparison comparison, u64 value, u64 value2);
+
+    /**
+     * Keeps the results of the previous scan that still match.
+     * @return the number of results
+     */
+    std::size_t NextScan(Comparison comparison, u64 value, u64 value2);
+
+    std::size_t GetResultCount() const;
+
+    /**
+     * Copies the addresses of up to max results to addresses.
+     * @return the number of addresses copied
+     */
+    std::size_t GetResults(VAddr* addresses, std::size_t max) const;
+
+    /// A mapped memory area of the searched process
+    struct Region {
+        VAddr base = 0;
+        u32 size = 0;
+        u8* memory = nullptr;
+
+        /// Values at the previous scan
+        std::vector<u8> snapshot;
+
+        /// One bit for each aligned value, set if it's a result
+        std::vector<u64> matches;
+    };
+
+private:
+    std::size_t Scan(Comparison comparison, u64 value, u64 value2, bool first);
+
+    /// Updates the host pointers of the regions, dropping the ones that aren't mapped anymore
+    void UpdateRegions();
+
+    Core::System& system;
+    ValueType type = ValueType::U32;
+    std::vector<Region> regions;
+    std::size_t result_count = 0;
+};
+
+} // namespace Memory
@@ -8,20 +8,32 @@
 #include <string>
 #include <vector>
 #include "common/bit_field.h"
+#include "common/cityhash.h"
 #include "common/common_types.h"
 #include "common/file_util.h"
+#include "common/hash.h"
 #include "common/logging/log.h"
 #include "common/string_util.h"
 #include "common/swap.h"
+#include "core/arm/arm_interface.h"
 #include "core/core.h"
 #include "core/hle/service/hid/hid.h"
 #include "core/hle/service/ir/extra_hid.h"
+#include "core/hw/gpu.h"
+#include "core/memory.h"
 #include "core/movie.h"
+#include "core/movie_file.h"
+#include "core/settings.h"
+#include "video_core/pica_state.h"
 
 namespace Core {
 
 /*static*/ Movie Movie::s_instance;
 
+Movie::Movie() = default;
+
+Movie::~Movie() = default;
+
 enum class PlayMode { None, Recording, Playing };
 
 enum class ControllerStateType : u8 {
@@ -29,9 +41,35 @@ enum class ControllerStateType : u8 {
     Touch,
     Accelerometer,
     Gyroscope,
-    ExtraHidResponse
+    ExtraHidResponse,
+    MemoryHash,
+    CpuHash,
+    GpuHash,
 };
 
+/// Bytes of FCRAM hashed per frame. The slices are hashed in rotation, because hashing all of it
+/// every frame would be too slow, and JIT fastmem writes can't be tracked to hash only dirty pages.
+constexpr std::size_t MEMORY_HASH_SLICE_SIZE = 0x100000;
+constexpr std::size_t MEMORY_HASH_SLICES = Memory::FCRAM_SIZE / MEMORY_HASH_SLICE_SIZE;
+
+static bool IsStateHash(ControllerStateType type) {
+    return type == ControllerStateType::MemoryHash || type == ControllerStateType::CpuHash ||
+           type == ControllerStateType::GpuHash;
+}
+
+static const char* GetStateHashName(ControllerStateType type) {
+    switch (type) {
+    case ControllerStateType::MemoryHash:
+        return "memory";
+    case ControllerStateType::CpuHash:
+        return "CPU";
+    case ControllerStateType::GpuHash:
+        return "GPU";
+    default:
+        return "unknown";
+    }
+}
+
 #pragma pack(push, 1)
 struct ControllerState {
     ControllerStateType type;
@@ -92,6 +130,9 @@ struct ControllerState {
                 BitField<20, 12, u32> circle_pad_pro_y;
             };
         } extra_hid_response;
+
+        /// Lower 48 bits of a state hash
+        std::array<u8, 6> state_hash;
     };
 };
 static_assert(sizeof(ControllerState) == 7, "ControllerState should be 7 bytes");
@@ -99,17 +140,15 @@ static_assert(sizeof(ControllerState) == 7, "ControllerState should be 7 bytes")
 
 constexpr std::array<u8, 4> header_magic_bytes{{'V', 'C', 'M', MovieVersion}};
 
-#pragma pack(push, 1)
-struct VCMHeader {
-    std::array<u8, 4>
-        filetype;      /// Unique identifier to check the file type (always `header_magic_bytes`)
-    u64_le program_id; /// ID of the ROM being executed. Also called title_id
-    u64_le clock_initial_time; /// The init time of the system clock
+/// Version 2 movies have no state hashes and version 2 and 3 movies aren't split in chunks, but
+/// they can still be played
+constexpr u8 OldestSupportedMovieVersion = 2;
 
-    std::array<u8, 236> reserved; /// Make heading 256 bytes so it has consistent size
-};
-static_assert(sizeof(VCMHeader) == 256, "VCMHeader should be 256 bytes");
-#pragma pack(pop)
+static bool IsSupportedFileType(const std::array<u8, 4>& filetype) {
+    return filetype[0] == header_magic_bytes[0] && filetype[1] == header_magic_bytes[1] &&
+           filetype[2] == header_magic_bytes[2] && filetype[3] >= OldestSupportedMovieVersion &&
+           filetype[3] <= MovieVersion;
+}
 
 bool Movie::IsPlayingInput() const {
     return play_mode == PlayMode::Playing;
@@ -118,15 +157,71 @@ bool Movie::IsRecordingInput() const {
     return play_mode == PlayMode::Recording;
 }
 
+static std::array<u8, 6> TruncateHash(u64 hash) {
+    std::array<u8, 6> truncated;
+    for (std::size_t i = 0; i < truncated.size(); ++i) {
+        truncated[i] = static_cast<u8>(hash >> (i * 8));
+    }
+    return truncated;
+}
+
+static std::array<u8, 6> ComputeStateHash(ControllerStateType type, u64 frame) {
+    switch (type) {
+    case ControllerStateType::MemoryHash: {
+        const std::size_t offset = (frame % MEMORY_HASH_SLICES) * MEMORY_HASH_SLICE_SIZE;
+        return TruncateHash(Common::ComputeHash64(
+            Core::System::GetInstance().Memory().GetFCRAMPointer(static_cast<u32>(offset)),
+            MEMORY_HASH_SLICE_SIZE));
+    }
+    case ControllerStateType::CpuHash: {
+        const ARM_Interface& cpu = Core::System::GetInstance().CPU();
+        std::array<u32, 16 + 1 + 64 + 2> registers;
+        std::size_t i = 0;
+        for (int reg = 0; reg < 16; ++reg) {
+            registers[i++] = cpu.GetReg(reg);
+        }
+        registers[i++] = cpu.GetCPSR();
+        for (int reg = 0; reg < 64; ++reg) {
+            registers[i++] = cpu.GetVFPReg(reg);
+        }
+        registers[i++] = cpu.GetVFPSystemReg(VFP_FPSCR);
+        registers[i++] = cpu.GetVFPSystemReg(VFP_FPEXC);
+        return TruncateHash(Common::ComputeStructHash64(registers));
+    }
+    case ControllerStateType::GpuHash: {
+        // The rendered pixels are in host textures when using the hardware renderer, and they
+        // differ between host GPUs, so hash the registers that produce them instead
+        const u64 hash = Common::ComputeStructHash64(GPU::g_regs);
+        const auto& pica_regs = Pica::g_state.regs.reg_array;
+        return TruncateHash(Common::CityHash64WithSeed(
+            reinterpret_cast<const char*>(pica_regs.data()), sizeof(pica_regs), hash));
+    }
+    default:
+        UNREACHABLE();
+        return {};
+    }
+}
+
 void Movie::CheckInputEnd() {
-    if (current_byte + sizeof(ControllerState) > recorded_input.size()) {
-        LOG_INFO(Movie, "Playback finished");
-        play_mode = PlayMode::None;
-        unix_timestamp = 0;
-        playback_completion_callback();
+    while (current_byte + sizeof(ControllerState) > recorded_input.size()) {
+        if (!reader->ReadNextChunk(recorded_input)) {
+            LOG_INFO(Movie, "Playback finished");
+            StopPlayback();
+            return;
+        }
+        current_byte = 0;
     }
 }
 
+void Movie::StopPlayback() {
+    play_mode = PlayMode::None;
+    reader.reset();
+    recorded_input.clear();
+    current_byte = 0;
+    unix_timestamp = 0;
+    playback_completion_callback();
+}
+
 void Movie::Play(Service::HID::PadState& pad_state, s16& circle_pad_x, s16& circle_pad_y) {
     ControllerState s;
     std::memcpy(&s, &recorded_input[current_byte], sizeof(ControllerState));
@@ -234,6 +329,36 @@ void Movie::Play(Service::IR::ExtraHIDResponse& extra_hid_response) {
         static_cast<u8>(s.extra_hid_response.zr_not_held));
 }
 
+bool Movie::CheckStateHashes() {
+    while (current_byte + sizeof(ControllerState) <= recorded_input.size()) {
+        ControllerState s;
+        std::memcpy(&s, &recorded_input[current_byte], sizeof(ControllerState));
+        if (!IsStateHash(s.type)) {
+            break;
+        }
+        current_byte += sizeof(ControllerState);
+
+        if (ComputeStateHash(s.type, frame) != s.state_hash) {
+            LOG_CRITICAL(Movie, "Playback desynced at frame {}, the {} state differs", frame,
+                         GetStateHashName(s.type));
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void Movie::RecordStateHashes() {
+    for (const ControllerStateType type : {ControllerStateType::MemoryHash,
+                                           ControllerStateType::CpuHash,
+                                           ControllerStateType::GpuHash}) {
+        ControllerState s;
+        s.type = type;
+        s.state_hash = ComputeStateHash(type, frame);
+        Record(s);
+    }
+}
+
 void Movie::Record(const ControllerState& controller_state) {
     recorded_input.resize(current_byte + sizeof(ControllerState));
     std::memcpy(&recorded_input[current_byte], &controller_state, sizeof(ControllerState));
@@ -320,7 +445,7 @@ u64 Movie::GetOverrideInitialTime() const {
 }
 
 Movie::ValidationResult Movie::ValidateHeader(const VCMHeader& header, u64 program_id) const {
-    if (header_magic_bytes != header.filetype) {
+    if (!IsSupportedFileType(header.filetype)) {
         LOG_ERROR(Movie, "Playback file does not have valid header");
         return ValidationResult::Invalid;
     }
@@ -337,44 +462,39 @@ Movie::ValidationResult Movie::ValidateHeader(const VCMHeader& header, u64 progr
     return ValidationResult::OK;
 }
 
+void Movie::FlushChunk() {
+    writer->AddChunk(chunk_first_frame, static_cast<u32>(frame - chunk_first_frame),
+                     std::move(recorded_input));
+    recorded_input.clear();
+    current_byte = 0;
+    chunk_first_frame = frame;
+}
+
 void Movie::SaveMovie() {
     LOG_INFO(Movie, "Saving recorded movie to '{}'", record_movie_file);
-    FileUtil::IOFile save_record(record_movie_file, "wb");
-
-    if (!save_record.IsGood()) {
-        LOG_ERROR(Movie, "Unable to open file to save movie");
-        return;
-    }
-
-    VCMHeader header = {};
-    header.filetype = header_magic_bytes;
-    header.clock_initial_time = unix_timestamp;
-
-    Core::System::GetInstance().GetAppLoader().ReadProgramId(header.program_id);
-
-    save_record.WriteBytes(&header, sizeof(VCMHeader));
-    save_record.WriteBytes(recorded_input.data(), recorded_input.size());
-
-    if (!save_record.IsGood()) {
-        LOG_ERROR(Movie, "Error saving movie");
-    }
+    FlushChunk();
+    writer->Finish(frame);
+    writer.reset();
 }
 
 void Movie::StartPlayback(const std::string& movie_file,
                           std::function<void()> completion_callback) {
     LOG_INFO(Movie, "Loading Movie for playback");
-    FileUtil::IOFile save_record(movie_file, "rb");
-    const u64 size = save_record.GetSize();
+    auto movie_reader = std::make_unique<MovieReader>(movie_file);
+
+    if (movie_reader->IsGood()) {
+        if (ValidateHeader(movie_reader->GetHeader()) != ValidationResult::Invalid) {
+            if (const u64 frame_count = movie_reader->GetFrameCount(); frame_count != 0) {
+                LOG_INFO(Movie, "Movie has {} frames", frame_count);
+            }
 
-    if (save_record.IsGood() && size > sizeof(VCMHeader)) {
-        VCMHeader header;
-        save_record.ReadArray(&header, 1);
-        if (ValidateHeader(header) != ValidationResult::Invalid) {
+            reader = std::move(movie_reader);
             play_mode = PlayMode::Playing;
-            recorded_input.resize(size - sizeof(VCMHeader));
-            save_record.ReadArray(recorded_input.data(), recorded_input.size());
+            recorded_input.clear();
             current_byte = 0;
+            frame = 0;
             playback_completion_callback = completion_callback;
+            CheckInputEnd();
         }
     } else {
         LOG_ERROR(Movie, "Failed to playback movie: Unable to open '{}'", movie_file);
@@ -383,8 +503,27 @@ void Movie::StartPlayback(const std::string& movie_file,
 
 void Movie::StartRecording(const std::string& movie_file) {
     LOG_INFO(Movie, "Enabling Movie recording");
+
+    VCMHeader header = {};
+    header.filetype = header_magic_bytes;
+    header.clock_initial_time = unix_timestamp;
+
+    Core::System::GetInstance().GetAppLoader().ReadProgramId(header.program_id);
+
+    writer = std::make_unique<MovieWriter>(movie_file, header);
+    if (!writer->IsGood()) {
+        LOG_ERROR(Movie, "Unable to open file to save movie");
+        writer.reset();
+        return;
+    }
+
     play_mode = PlayMode::Recording;
     record_movie_file = movie_file;
+    record_state_hashes = Settings::values.record_movie_state_hashes;
+    recorded_input.clear();
+    current_byte = 0;
+    frame = 0;
+    chunk_first_frame = 0;
 }
 
 static std::optional<VCMHeader> ReadHeader(const std::string& movie_file) {
@@ -398,7 +537,7 @@ static std::optional<VCMHeader> ReadHeader(const std::string& movie_file) {
     VCMHeader header;
     save_record.ReadArray(&header, 1);
 
-    if (header_magic_bytes != header.filetype) {
+    if (!IsSupportedFileType(header.filetype)) {
         return std::nullopt;
     }
 
@@ -445,16 +584,24 @@ void Movie::Shutdown() {
     }
 
     play_mode = PlayMode::None;
+    reader.reset();
     recorded_input.resize(0);
     record_movie_file.clear();
     current_byte = 0;
     unix_timestamp = 0;
+    frame = 0;
+    chunk_first_frame = 0;
 }
 
 template <typename... Targs>
 void Movie::Handle(Targs&... Fargs) {
     if (IsPlayingInput()) {
         ASSERT(current_byte + sizeof(ControllerState) <= recorded_input.size());
+        if (IsStateHash(static_cast<ControllerStateType>(recorded_input[current_byte]))) {
+            LOG_CRITICAL(Movie, "Playback desynced at frame {}, the frame ended later", frame);
+            StopPlayback();
+            return;
+        }
         Play(Fargs...);
         CheckInputEnd();
     } else if (IsRecordingInput()) {
@@ -483,4 +630,22 @@ void Movie::HandleExtraHidResponse(Service::IR::ExtraHIDResponse& extra_hid_resp
     Handle(extra_hid_response);
 }
 
+void Movie::HandleFrame() {
+    if (IsPlayingInput()) {
+        if (!CheckStateHashes()) {
+            StopPlayback();
+            return;
+        }
+        CheckInputEnd();
+    } else if (IsRecordingInput() && record_state_hashes) {
+        RecordStateHashes();
+    }
+
+    ++frame;
+
+    if (IsRecordingInput() && frame - chunk_first_frame == MOVIE_FRAMES_PER_CHUNK) {
+        FlushChunk();
+    }
+}
+
 } // namespace Core
@@ -5,6 +5,9 @@
 #pragma once
 
 #include <functional>
+#include <memory>
+#include <string>
+#include <vector>
 #include "common/common_types.h"
 
 namespace Service {
@@ -24,8 +27,10 @@ namespace Core {
 struct VCMHeader;
 struct ControllerState;
 enum class PlayMode;
+class MovieReader;
+class MovieWriter;
 
-constexpr u8 MovieVersion = 2;
+constexpr u8 MovieVersion = 4;
 
 class Movie {
 public:
@@ -35,6 +40,9 @@ public:
         Invalid,
     };
 
+    Movie();
+    ~Movie();
+
     /**
      * Gets the instance of the Movie singleton class.
      * @returns Reference to the instance of the Movie singleton class.
@@ -91,6 +99,15 @@ public:
      * When playing: Replaces the given input states with the ones stored in the playback file
      */
     void HandleExtraHidResponse(Service::IR::ExtraHIDResponse& extra_hid_response);
+
+    /**
+     * Called at the end of every emulated frame.
+     * When recording: Records hashes of the emulated state if enabled in the settings
+     * When playing: Compares the hashes stored in the playback file with the emulated state, and
+     * stops the playback if they differ
+     */
+    void HandleFrame();
+
     bool IsPlayingInput() const;
     bool IsRecordingInput() const;
 
@@ -98,6 +115,11 @@ private:
     static Movie s_instance;
 
     void CheckInputEnd();
+    void StopPlayback();
+
+    /// Returns false if a state hash stored for this frame doesn't match the emulated state
+    bool CheckStateHashes();
+    void RecordStateHashes();
 
     template <typename... Targs>
     void Handle(Targs&... Fargs);
@@ -121,13 +143,21 @@ private:
 
     ValidationResult ValidateHeader(const VCMHeader& header, u64 program_id = 0) const;
 
+    /// Queues the input recorded since the last chunk to be written
+    void FlushChunk();
+
     void SaveMovie();
 
     PlayMode play_mode;
     std::string record_movie_file;
-    std::vector<u8> recorded_input;
+    std::unique_ptr<MovieReader> reader;
+    std::unique_ptr<MovieWriter> writer;
+    std::vector<u8> recorded_input; ///< Input of the current chunk
     u64 unix_timestamp;
     std::function<void()> playback_completion_callback;
     std::size_t current_byte = 0;
+    bool record_state_hashes = false;
+    u64 frame = 0;
+    u64 chunk_first_frame = 0;
 };
 } // namespace Core
\ No newline at end of file
@@ -0,0 +1,192 @@
+// Copyright 2020 vvctre project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <cstdio>
+#include <string>
+#include <cryptopp/filters.h>
+#include <cryptopp/zdeflate.h>
+#include <cryptopp/zinflate.h>
+#include "common/logging/log.h"
+#include "core/movie_file.h"
+
+namespace Core {
+
+constexpr std::array<u8, 4> chunk_magic_bytes{{'V', 'C', 'M', 'C'}};
+
+MovieWriter::MovieWriter(const std::string& path, const VCMHeader& header)
+    : file(path, "wb"), header(header) {
+    if (!file.IsOpen()) {
+        LOG_ERROR(Movie, "Unable to create '{}'", path);
+        return;
+    }
+
+    file.WriteObject(header);
+    file.Flush();
+    write_thread = std::thread(&MovieWriter::WriteThread, this);
+}
+
+MovieWriter::~MovieWriter() {
+    if (write_thread.joinable()) {
+        Finish(0);
+    }
+}
+
+bool MovieWriter::IsGood() const {
+    return file.IsGood();
+}
+
+void MovieWriter::AddChunk(u64 first_frame, u32 frame_count, std::vector<u8> data) {
+    queue.Push(Chunk{first_frame, frame_count, std::move(data), false});
+}
+
+void MovieWriter::Finish(u64 frame_count) {
+    if (!write_thread.joinable()) {
+        return;
+    }
+
+    queue.Push(Chunk{0, 0, {}, true});
+    write_thread.join();
+
+    header.index_offset = file.Tell();
+    header.frame_count = frame_count;
+    file.WriteArray(index.data(), index.size());
+    file.Seek(0, SEEK_SET);
+    file.WriteObject(header);
+    file.Close();
+}
+
+void MovieWriter::WriteThread() {
+    while (true) {
+        Chunk chunk = queue.PopWait();
+        if (chunk.last) {
+            return;
+        }
+
+        std::string compressed;
+        CryptoPP::Deflator deflator(new CryptoPP::StringSink(compressed));
+        deflator.Put(chunk.data.data(), chunk.data.size());
+        deflator.MessageEnd();
+
+        VCMChunkHeader chunk_header;
+        chunk_header.magic = chunk_magic_bytes;
+        chunk_header.first_frame = chunk.first_frame;
+        chunk_header.frame_count = chunk.frame_count;
+        chunk_header.size = static_cast<u32>(chunk.data.size());
+        chunk_header.compressed_size = static_cast<u32>(compressed.size());
+
+        index.push_back(VCMIndexEntry{chunk.first_frame, file.Tell()});
+        file.WriteObject(chunk_header);
+        file.WriteString(compressed);
+        file.Flush();
+
+        if (!file.IsGood()) {
+            LOG_ERROR(Movie, "Error writing movie");
+        }
+    }
+}
+
+MovieReader::MovieReader(const std::string& path) : file(path, "rb") {
+    if (!file.IsOpen() || file.GetSize() <= sizeof(VCMHeader) ||
+        file.ReadArray(&header, 1) != 1) {
+        return;
+    }
+
+    good = true;
+    chunked = header.filetype[3] >= 4;
+    if (!chunked) {
+        return;
+    }
+
+    if (header.index_offset == 0) {
+        LOG_WARNING(Movie, "Movie recording wasn't stopped, looking for complete chunks");
+        RebuildIndex();
+        return;
+    }
+
+    index.resize((file.GetSize() - header.index_offset) / sizeof(VCMIndexEntry));
+    file.Seek(header.index_offset, SEEK_SET);
+    if (file.ReadArray(index.data(), index.size()) != index.size()) {
+        LOG_WARNING(Movie, "Movie index is incomplete, looking for complete chunks");
+        RebuildIndex();
+    }
+}
+
+bool MovieReader::IsGood() const {
+    return good;
+}
+
+const VCMHeader& MovieReader::GetHeader() const {
+    return header;
+}
+
+u64 MovieReader::GetFrameCount() const {
+    return header.frame_count;
+}
+
+void MovieReader::RebuildIndex() {
+    index.clear();
+
+    const u64 size = file.GetSize();
+    u64 offset = sizeof(VCMHeader);
+    while (offset + sizeof(VCMChunkHeader) <= size) {
+        VCMChunkHeader chunk_header;
+        file.Seek(offset, SEEK_SET);
+        if (file.ReadArray(&chunk_header, 1) != 1 || chunk_header.magic != chunk_magic_bytes ||
+            offset + sizeof(VCMChunkHeader) + chunk_header.compressed_size > size) {
+            break;
+        }
+
+        index.push_back(VCMIndexEntry{chunk_header.first_frame, offset});
+        offset += sizeof(VCMChunkHeader) + chunk_header.compressed_size;
+    }
+}
+
+bool MovieReader::ReadNextChunk(std::vector<u8>& data) {
+    if (!good) {
+        return false;
+    }
+
+    if (!chunked) {
+        if (next_chunk != 0) {
+            return false;
+        }
+        ++next_chunk;
+
+        data.resize(file.GetSize() - sizeof(VCMHeader));
+        file.Seek(sizeof(VCMHeader), SEEK_SET);
+        return file.ReadBytes(data.data(), data.size()) == data.size();
+    }
+
+    if (next_chunk == index.size()) {
+        return false;
+    }
+
+    VCMChunkHeader chunk_header;
+    file.Seek(index[next_chunk++].offset, SEEK_SET);
+    if (file.ReadArray(&chunk_header, 1) != 1 || chunk_header.magic != chunk_magic_bytes) {
+        LOG_ERROR(Movie, "Movie chunk {} is corrupted", next_chunk - 1);
+        return false;
+    }
+
+    std::vector<u8> compressed(chunk_header.compressed_size);
+    if (file.ReadBytes(compressed.data(), compressed.size()) != compressed.size()) {
+        LOG_ERROR(Movie, "Movie chunk {} is incomplete", next_chunk - 1);
+        return false;
+    }
+
+    data.resize(chunk_header.size);
+    try {
+        CryptoPP::Inflator inflator(new CryptoPP::ArraySink(data.data(), data.size()));
+        inflator.Put(compressed.data(), compressed.size());
+        inflator.MessageEnd();
+    } catch (const CryptoPP::Exception& exception) {
+        LOG_ERROR(Movie, "Failed to decompress movie chunk {}: {}", next_chunk - 1,
+                  exception.what());
+        return false;
+    }
+
+    return true;
+}
+
+} // namespace Core
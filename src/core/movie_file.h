@@ -0,0 +1,124 @@
+// Copyright 2020 vvctre project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <array>
+#include <string>
+#include <thread>
+#include <vector>
+#include "common/common_types.h"
+#include "common/file_util.h"
+#include "common/swap.h"
+#include "common/threadsafe_queue.h"
+
+namespace Core {
+
+/// Frames stored in each chunk of a movie. Up to this many frames are lost if vvctre crashes.
+constexpr u64 MOVIE_FRAMES_PER_CHUNK = 600;
+
+#pragma pack(push, 1)
+struct VCMHeader {
+    std::array<u8, 4>
+        filetype;      /// Unique identifier to check the file type (always `header_magic_bytes`)
+    u64_le program_id; /// ID of the ROM being executed. Also called title_id
+    u64_le clock_initial_time; /// The init time of the system clock
+
+    // Version 4
+    u64_le index_offset; /// Offset of the chunk index, 0 if the recording wasn't stopped
+    u64_le frame_count;  /// Number of frames, 0 if the recording wasn't stopped
+
+    std::array<u8, 220> reserved; /// Make heading 256 bytes so it has consistent size
+};
+static_assert(sizeof(VCMHeader) == 256, "VCMHeader should be 256 bytes");
+
+/// Header of a chunk of the input stream. The input is compressed with raw Deflate.
+struct VCMChunkHeader {
+    std::array<u8, 4> magic;
+    u64_le first_frame;
+    u32_le frame_count;
+    u32_le size; /// Uncompressed size
+    u32_le compressed_size;
+};
+static_assert(sizeof(VCMChunkHeader) == 24, "VCMChunkHeader should be 24 bytes");
+
+/// Entry of the chunk index written at the end of a movie
+struct VCMIndexEntry {
+    u64_le first_frame;
+    u64_le offset;
+};
+static_assert(sizeof(VCMIndexEntry) == 16, "VCMIndexEntry should be 16 bytes");
+#pragma pack(pop)
+
+/**
+ * Writes a movie's input stream in compressed chunks on a separate thread, flushing the file after
+ * each chunk so a recording survives a crash.
+ */
+class MovieWriter {
+public:
+    /// Creates the file and writes the header
+    MovieWriter(const std::string& path, const VCMHeader& header);
+
+    /// Finishes the movie if Finish wasn't called
+    ~MovieWriter();
+
+    bool IsGood() const;
+
+    /// Queues the input of the frames starting at first_frame to be compressed and written
+    void AddChunk(u64 first_frame, u32 frame_count, std::vector<u8> data);
+
+    /// Waits for the queued chunks to be written, then writes the index and updates the header
+    void Finish(u64 frame_count);
+
+private:
+    struct Chunk {
+        u64 first_frame = 0;
+        u32 frame_count = 0;
+        std::vector<u8> data;
+        bool last = false;
+    };
+
+    void WriteThread();
+
+    FileUtil::IOFile file;
+    VCMHeader header;
+    std::vector<VCMIndexEntry> index;
+    Common::SPSCQueue<Chunk> queue;
+    std::thread write_thread;
+};
+
+/**
+ * Reads a movie's input stream one chunk at a time.
+ * Version 2 and 3 movies are read as a single uncompressed chunk.
+ */
+class MovieReader {
+public:
+    explicit MovieReader(const std::string& path);
+
+    bool IsGood() const;
+
+    const VCMHeader& GetHeader() const;
+
+    /// Gets the number of frames, or 0 if it's not known
+    u64 GetFrameCount() const;
+
+    /**
+     * Reads and decompresses the next chunk.
+     * @return false at the end of the movie, or if the chunk is corrupted
+     */
+    bool ReadNextChunk(std::vector<u8>& data);
+
+private:
+    /// Finds the chunks of a movie that wasn't finished, stopping at the first incomplete one
+    void RebuildIndex();
+
+    FileUtil::IOFile file;
+    VCMHeader header{};
+    bool good = false;
+    bool chunked = false;
+    std::vector<VCMIndexEntry> index;
+    std::size_t next_chunk = 0;
+};
+
+} // namespace Core
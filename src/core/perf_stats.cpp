@@ -11,6 +11,7 @@
 #include <fmt/chrono.h>
 #include <fmt/format.h>
 #include "common/file_util.h"
+#include "common/profiler.h"
 #include "core/core.h"
 #include "core/hw/gpu.h"
 #include "core/perf_stats.h"
@@ -59,6 +60,8 @@ void PerfStats::BeginSystemFrame() {
 }
 
 void PerfStats::EndSystemFrame() {
+    Common::Profiler::EndFrame();
+
     std::lock_guard lock{object_mutex};
 
     auto frame_end = Clock::now();
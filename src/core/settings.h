@@ -126,6 +126,7 @@ struct Values {
     std::string file_path;
     std::string play_movie;
     std::string record_movie;
+    bool record_movie_state_hashes = false; // Adds state hashes to check playback with
     int region_value = REGION_VALUE_AUTO_SELECT;
     std::string log_filter = "*:Info";
     InitialClock initial_clock = InitialClock::SystemTime;
@@ -168,11 +169,15 @@ struct Values {
     bool hardware_shader_accurate_multiplication = false;
     bool use_shader_jit = true;
     bool enable_vsync = false;
+    u32 frames_in_flight = 2; // 0 for no limit
     bool dump_textures = false;
     bool custom_textures = false;
     bool preload_textures = false;
+    u32 custom_textures_memory = 2048; // MiB
     bool enable_linear_filtering = true;
     bool sharper_distant_objects = false;
+    u32 surface_cache_memory = 0;       // MiB, 0 for no limit
+    u32 filtered_textures_memory = 256; // MiB, 0 to disable the cache
     u16 resolution = 1;
     float background_color_red = 0.0f;
     float background_color_green = 0.0f;
@@ -283,6 +288,7 @@ struct Values {
     u16 multiplayer_port = 24872;
     std::string multiplayer_nickname;
     std::string multiplayer_password;
+    bool use_local_wireless = false;
 } extern values;
 
 void Apply();
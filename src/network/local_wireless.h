@@ -0,0 +1,47 @@
+// Copyright 2020 vvctre project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <memory>
+#include "network/wifi_transport.h"
+
+namespace Network {
+
+/**
+ * Local wireless link between emulator instances running on the same host. Frames are exchanged
+ * through a ring buffer in named shared memory instead of through a room server, so there is no
+ * serialization and no network round trip. Every instance that joins sees the frames of all the
+ * others.
+ */
+class LocalWireless final : public WifiTransport {
+public:
+    LocalWireless();
+    ~LocalWireless() override;
+
+    /**
+     * Maps the shared ring buffer, creating it if no other instance did yet, and starts the thread
+     * that receives frames. A random MAC address is picked for this instance.
+     * @return Whether the link could be joined.
+     */
+    bool Join();
+
+    /**
+     * Stops receiving frames and unmaps the shared ring buffer.
+     */
+    void Leave();
+
+    bool IsJoined() const override;
+    const MacAddress& GetMacAddress() const override;
+    void SendWifiPacket(const WifiPacket& packet) override;
+    PacketCallbackHandle BindOnWifiPacketReceived(
+        std::function<void(const WifiPacket&)> callback) override;
+    void UnbindOnWifiPacketReceived(PacketCallbackHandle handle) override;
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl;
+};
+
+} // namespace Network
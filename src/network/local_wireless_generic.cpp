@@ -0,0 +1,42 @@
+// Copyright 2020 vvctre project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include "common/logging/log.h"
+#include "network/local_wireless.h"
+
+namespace Network {
+
+struct LocalWireless::Impl {
+    MacAddress mac_address{};
+};
+
+LocalWireless::LocalWireless() : impl{std::make_unique<Impl>()} {}
+
+LocalWireless::~LocalWireless() = default;
+
+bool LocalWireless::Join() {
+    LOG_ERROR(Network, "Local wireless isn't supported on this platform");
+    return false;
+}
+
+void LocalWireless::Leave() {}
+
+bool LocalWireless::IsJoined() const {
+    return false;
+}
+
+const MacAddress& LocalWireless::GetMacAddress() const {
+    return impl->mac_address;
+}
+
+void LocalWireless::SendWifiPacket(const WifiPacket& packet) {}
+
+WifiTransport::PacketCallbackHandle LocalWireless::BindOnWifiPacketReceived(
+    std::function<void(const WifiPacket&)> callback) {
+    return std::make_shared<std::function<void(const WifiPacket&)>>(callback);
+}
+
+void LocalWireless::UnbindOnWifiPacketReceived(PacketCallbackHandle handle) {}
+
+} // namespace Network
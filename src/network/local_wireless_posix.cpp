@@ -0,0 +1,324 @@
+// Copyright 2020 vvctre project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <cstring>
+#include <mutex>
+#include <optional>
+#include <random>
+#include <set>
+#include <thread>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
+#include "common/logging/log.h"
+#include "network/local_wireless.h"
+
+namespace Network {
+
+namespace {
+
+constexpr char SharedMemoryName[] = "/vvctre-local-wireless";
+
+/// Number of frames the ring holds before the oldest one is overwritten
+constexpr std::size_t RingSize = 256;
+
+/// Largest frame that fits in a ring slot
+constexpr std::size_t MaxFrameSize = 0x800;
+
+/// How long a receiver waits for a claimed slot to be completed before skipping it, in case the
+/// sender died while writing it
+constexpr auto SlotWriteTimeout = std::chrono::milliseconds(50);
+
+/// A frame in the ring. sequence is 0 while the slot is being written, and the sequence number of
+/// the frame plus one once it's complete.
+struct Slot {
+    std::atomic<u64> sequence;
+    WifiPacket::PacketType type;
+    u8 channel;
+    MacAddress transmitter_address;
+    MacAddress destination_address;
+    u16 size;
+    std::array<u8, MaxFrameSize> data;
+};
+
+/// Layout of the shared memory. A zero-filled mapping is a valid empty ring.
+struct Ring {
+    std::atomic<u64> write_sequence; ///< Number of frames ever sent
+    std::atomic<u32> wakeup;         ///< Incremented after every sent frame
+    u32 members;                     ///< Number of joined instances, guarded by a file lock
+    std::array<Slot, RingSize> slots;
+};
+
+static_assert(std::atomic<u64>::is_always_lock_free && std::atomic<u32>::is_always_lock_free,
+              "The ring atomics must be lock-free to be shared between processes");
+
+void WaitForFrames(std::atomic<u32>& wakeup, u32 value) {
+#ifdef __linux__
+    // The futex is process-shared, so the sending instance wakes us up directly. The timeout lets
+    // the receiving thread notice when it's asked to stop.
+    timespec timeout{0, 100'000'000};
+    syscall(SYS_futex, reinterpret_cast<u32*>(&wakeup), FUTEX_WAIT, value, &timeout, nullptr, 0);
+#else
+    if (wakeup.load(std::memory_order_acquire) == value) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+#endif
+}
+
+void WakeReceivers(std::atomic<u32>& wakeup) {
+    wakeup.fetch_add(1, std::memory_order_release);
+#ifdef __linux__
+    syscall(SYS_futex, reinterpret_cast<u32*>(&wakeup), FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+#endif
+}
+
+} // Anonymous namespace
+
+struct LocalWireless::Impl {
+    Ring* ring = nullptr;
+    int fd = -1; ///< Shared memory object, locked while changing the member count
+    std::atomic<bool> joined{false};
+    MacAddress mac_address{};
+
+    /// Thread that receives and dispatches frames
+    std::thread receive_thread;
+
+    std::mutex callback_mutex; ///< The mutex used for handling callbacks
+    std::set<PacketCallbackHandle> callbacks;
+
+    void ReceiveLoop();
+    void Invoke(const WifiPacket& packet);
+};
+
+void LocalWireless::Impl::ReceiveLoop() {
+    u64 next_sequence = ring->write_sequence.load(std::memory_order_acquire);
+    WifiPacket packet;
+
+    // When the receiver started waiting for the slot of next_sequence to be completed
+    std::optional<std::chrono::steady_clock::time_point> slot_wait_start;
+
+    while (joined) {
+        const u32 wakeup = ring->wakeup.load(std::memory_order_acquire);
+        const u64 write_sequence = ring->write_sequence.load(std::memory_order_acquire);
+
+        if (write_sequence - next_sequence > RingSize) {
+            LOG_WARNING(Network, "Receiver fell behind, dropped {} frames",
+                        write_sequence - next_sequence - RingSize);
+            next_sequence = write_sequence - RingSize;
+        }
+
+        if (next_sequence == write_sequence) {
+            WaitForFrames(ring->wakeup, wakeup);
+            continue;
+        }
+
+        Slot& slot = ring->slots[next_sequence % RingSize];
+        const u64 slot_sequence = slot.sequence.load(std::memory_order_acquire);
+        if (slot_sequence > next_sequence + 1) {
+            // Overwritten by a newer frame before we got to it
+            slot_wait_start.reset();
+            ++next_sequence;
+            continue;
+        }
+        if (slot_sequence != next_sequence + 1) {
+            // The sender claimed the slot but hasn't finished writing it yet
+            const auto now = std::chrono::steady_clock::now();
+            if (!slot_wait_start) {
+                slot_wait_start = now;
+            } else if (now - *slot_wait_start > SlotWriteTimeout) {
+                LOG_WARNING(Network, "Frame {} was never completed, skipping it", next_sequence);
+                slot_wait_start.reset();
+                ++next_sequence;
+                continue;
+            }
+            std::this_thread::yield();
+            continue;
+        }
+        slot_wait_start.reset();
+
+        packet.type = slot.type;
+        packet.channel = slot.channel;
+        packet.transmitter_address = slot.transmitter_address;
+        packet.destination_address = slot.destination_address;
+        packet.data.assign(slot.data.begin(),
+                           slot.data.begin() + std::min<std::size_t>(slot.size, MaxFrameSize));
+
+        // Discard the copy if the slot was reused while we were reading it
+        std::atomic_thread_fence(std::memory_order_acquire);
+        const bool overwritten = slot.sequence.load(std::memory_order_relaxed) != slot_sequence;
+        ++next_sequence;
+
+        if (overwritten || packet.transmitter_address == mac_address) {
+            continue;
+        }
+
+        if (packet.destination_address == BroadcastMac ||
+            packet.destination_address == mac_address) {
+            Invoke(packet);
+        }
+    }
+}
+
+void LocalWireless::Impl::Invoke(const WifiPacket& packet) {
+    std::lock_guard lock(callback_mutex);
+    for (const auto& callback : callbacks) {
+        (*callback)(packet);
+    }
+}
+
+LocalWireless::LocalWireless() : impl{std::make_unique<Impl>()} {}
+
+LocalWireless::~LocalWireless() {
+    Leave();
+}
+
+bool LocalWireless::Join() {
+    if (IsJoined()) {
+        return true;
+    }
+
+    int fd;
+    while (true) {
+        fd = shm_open(SharedMemoryName, O_RDWR | O_CREAT, 0600);
+        if (fd == -1) {
+            LOG_ERROR(Network, "shm_open failed: {}", std::strerror(errno));
+            return false;
+        }
+
+        flock(fd, LOCK_EX);
+
+        // The last member may have unlinked the object between shm_open and flock. Joining it would
+        // leave this instance alone, so open the new one instead.
+        struct stat status;
+        if (fstat(fd, &status) == 0 && status.st_nlink != 0) {
+            break;
+        }
+
+        flock(fd, LOCK_UN);
+        close(fd);
+    }
+
+    // Resizing to the same size is a no-op, so this doesn't disturb instances that already joined
+    if (ftruncate(fd, sizeof(Ring)) != 0) {
+        LOG_ERROR(Network, "ftruncate failed: {}", std::strerror(errno));
+        flock(fd, LOCK_UN);
+        close(fd);
+        return false;
+    }
+
+    void* memory = mmap(nullptr, sizeof(Ring), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (memory == MAP_FAILED) {
+        LOG_ERROR(Network, "mmap failed: {}", std::strerror(errno));
+        flock(fd, LOCK_UN);
+        close(fd);
+        return false;
+    }
+
+    impl->ring = static_cast<Ring*>(memory);
+    impl->fd = fd;
+    ++impl->ring->members;
+    flock(fd, LOCK_UN);
+
+    // Nintendo OUI followed by random bytes
+    std::random_device random_device;
+    impl->mac_address = {0x40,
+                         0xF4,
+                         0x07,
+                         static_cast<u8>(random_device()),
+                         static_cast<u8>(random_device()),
+                         static_cast<u8>(random_device())};
+
+    impl->joined = true;
+    impl->receive_thread = std::thread(&Impl::ReceiveLoop, impl.get());
+
+    LOG_INFO(Network, "Joined local wireless as {:02X}:{:02X}:{:02X}:{:02X}:{:02X}:{:02X}",
+             impl->mac_address[0], impl->mac_address[1], impl->mac_address[2],
+             impl->mac_address[3], impl->mac_address[4], impl->mac_address[5]);
+    return true;
+}
+
+void LocalWireless::Leave() {
+    if (!IsJoined()) {
+        return;
+    }
+
+    impl->joined = false;
+    WakeReceivers(impl->ring->wakeup);
+    impl->receive_thread.join();
+
+    // The last member removes the shared memory so the next session starts with an empty ring
+    flock(impl->fd, LOCK_EX);
+    if (--impl->ring->members == 0) {
+        shm_unlink(SharedMemoryName);
+    }
+    flock(impl->fd, LOCK_UN);
+    close(impl->fd);
+    impl->fd = -1;
+
+    munmap(impl->ring, sizeof(Ring));
+    impl->ring = nullptr;
+}
+
+bool LocalWireless::IsJoined() const {
+    return impl->joined;
+}
+
+const MacAddress& LocalWireless::GetMacAddress() const {
+    return impl->mac_address;
+}
+
+void LocalWireless::SendWifiPacket(const WifiPacket& packet) {
+    if (!IsJoined()) {
+        return;
+    }
+
+    if (packet.data.size() > MaxFrameSize) {
+        LOG_ERROR(Network, "Frame of {} bytes is too large, dropping it", packet.data.size());
+        return;
+    }
+
+    Ring& ring = *impl->ring;
+    const u64 sequence = ring.write_sequence.fetch_add(1, std::memory_order_acq_rel);
+    Slot& slot = ring.slots[sequence % RingSize];
+
+    slot.sequence.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    slot.type = packet.type;
+    slot.channel = packet.channel;
+    slot.transmitter_address = packet.transmitter_address;
+    slot.destination_address = packet.destination_address;
+    slot.size = static_cast<u16>(packet.data.size());
+    std::memcpy(slot.data.data(), packet.data.data(), packet.data.size());
+
+    slot.sequence.store(sequence + 1, std::memory_order_release);
+    WakeReceivers(ring.wakeup);
+}
+
+WifiTransport::PacketCallbackHandle LocalWireless::BindOnWifiPacketReceived(
+    std::function<void(const WifiPacket&)> callback) {
+    std::lock_guard lock(impl->callback_mutex);
+    PacketCallbackHandle handle =
+        std::make_shared<std::function<void(const WifiPacket&)>>(callback);
+    impl->callbacks.insert(handle);
+    return handle;
+}
+
+void LocalWireless::UnbindOnWifiPacketReceived(PacketCallbackHandle handle) {
+    std::lock_guard lock(impl->callback_mutex);
+    impl->callbacks.erase(handle);
+}
+
+} // namespace Network
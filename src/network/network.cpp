@@ -10,6 +10,7 @@
 namespace Network {
 
 static std::shared_ptr<RoomMember> g_room_member;
+static std::shared_ptr<LocalWireless> g_local_wireless;
 
 bool Init() {
     if (enet_initialize() != 0) {
@@ -25,7 +26,27 @@ std::weak_ptr<RoomMember> GetRoomMember() {
     return g_room_member;
 }
 
+bool StartLocalWireless() {
+    auto local_wireless = std::make_shared<LocalWireless>();
+    if (!local_wireless->Join()) {
+        return false;
+    }
+    g_local_wireless = std::move(local_wireless);
+    return true;
+}
+
+std::weak_ptr<WifiTransport> GetWifiTransport() {
+    if (g_local_wireless) {
+        return g_local_wireless;
+    }
+    return g_room_member;
+}
+
 void Shutdown() {
+    if (g_local_wireless) {
+        g_local_wireless->Leave();
+        g_local_wireless.reset();
+    }
     if (g_room_member) {
         if (g_room_member->IsConnected())
             g_room_member->Leave();
@@ -5,6 +5,7 @@
 #pragma once
 
 #include <memory>
+#include "network/local_wireless.h"
 #include "network/room_member.h"
 
 namespace Network {
@@ -15,6 +16,14 @@ bool Init();
 /// Returns a pointer to the room member handle
 std::weak_ptr<RoomMember> GetRoomMember();
 
+/// Joins the shared memory link between instances on this host, which then replaces the room
+/// member for wireless communication.
+bool StartLocalWireless();
+
+/// Returns the transport wireless frames are sent through: the local wireless link if it was
+/// started, otherwise the room member
+std::weak_ptr<WifiTransport> GetWifiTransport();
+
 /// Unregisters the network device and the room member, and shut them down.
 void Shutdown();
 
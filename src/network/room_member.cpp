@@ -529,6 +529,10 @@ bool RoomMember::IsConnected() const {
     return room_member_impl->IsConnected();
 }
 
+bool RoomMember::IsJoined() const {
+    return GetState() == State::Joined;
+}
+
 void RoomMember::SendWifiPacket(const WifiPacket& wifi_packet) {
     Packet packet;
     packet << static_cast<u8>(IdWifiPacket);
@@ -589,6 +593,10 @@ RoomMember::CallbackHandle<StatusMessageEntry> RoomMember::BindOnStatusMessageRe
     return room_member_impl->Bind(callback);
 }
 
+void RoomMember::UnbindOnWifiPacketReceived(CallbackHandle<WifiPacket> handle) {
+    Unbind(handle);
+}
+
 template <typename T>
 void RoomMember::Unbind(CallbackHandle<T> handle) {
     std::lock_guard lock(room_member_impl->callback_mutex);
@@ -10,6 +10,7 @@
 #include <string>
 #include <vector>
 #include "common/common_types.h"
+#include "network/wifi_transport.h"
 
 namespace Network {
 
@@ -38,34 +39,10 @@ struct GameInfo {
     u64 id = 0;
 };
 
-using MacAddress = std::array<u8, 6>;
-
 /// A special MAC address that tells the room we're joining to assign us a MAC address
 /// automatically.
 constexpr MacAddress NoPreferredMac = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
 
-// 802.11 broadcast MAC address
-constexpr MacAddress BroadcastMac = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
-
-/// Information about the received WiFi packets.
-/// Acts as our own 802.11 header.
-struct WifiPacket {
-    enum class PacketType : u8 {
-        Beacon,
-        Data,
-        Authentication,
-        AssociationResponse,
-        Deauthentication,
-        NodeMap
-    };
-    PacketType type;      ///< The type of 802.11 frame.
-    std::vector<u8> data; ///< Raw 802.11 frame data, starting at the management frame header
-                          /// for management frames.
-    MacAddress transmitter_address; ///< Mac address of the transmitter.
-    MacAddress destination_address; ///< Mac address of the receiver.
-    u8 channel;                     ///< WiFi channel where this frame was transmitted.
-};
-
 /// Represents a chat message.
 struct ChatEntry {
     std::string nickname;
@@ -110,7 +87,7 @@ struct StatusMessageEntry {
 /**
  * This is what a client [person joining a server] would use.
  */
-class RoomMember final {
+class RoomMember final : public WifiTransport {
 public:
     enum class State : u8 {
         Uninitialized, ///< Not initialized
@@ -184,7 +161,7 @@ public:
     /**
      * Returns the MAC address of the RoomMember.
      */
-    const MacAddress& GetMacAddress() const;
+    const MacAddress& GetMacAddress() const override;
 
     /**
      * Returns information about the room we're currently connected to.
@@ -196,6 +173,11 @@ public:
      */
     bool IsConnected() const;
 
+    /**
+     * Returns whether we've joined a room and can exchange WiFi packets with it.
+     */
+    bool IsJoined() const override;
+
     /**
      * Attempts to join a room at the specified address and port, using the specified nickname.
      * A console ID hash is passed in to check console ID conflicts.
@@ -209,7 +191,7 @@ public:
      * Sends a WiFi packet to the room.
      * @param packet The WiFi packet to send.
      */
-    void SendWifiPacket(const WifiPacket& packet);
+    void SendWifiPacket(const WifiPacket& packet) override;
 
     /**
      * Sends a chat message to the room.
@@ -262,7 +244,9 @@ public:
      * @return A handle used for removing the function from the registered list
      */
     CallbackHandle<WifiPacket> BindOnWifiPacketReceived(
-        std::function<void(const WifiPacket&)> callback);
+        std::function<void(const WifiPacket&)> callback) override;
+
+    void UnbindOnWifiPacketReceived(CallbackHandle<WifiPacket> handle) override;
 
     /**
      * Binds a function to an event that will be triggered every time the RoomInformation changes.
@@ -0,0 +1,84 @@
+// Copyright 2020 vvctre project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <array>
+#include <functional>
+#include <memory>
+#include <vector>
+#include "common/common_types.h"
+
+namespace Network {
+
+using MacAddress = std::array<u8, 6>;
+
+// 802.11 broadcast MAC address
+constexpr MacAddress BroadcastMac = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
+
+/// Information about the received WiFi packets.
+/// Acts as our own 802.11 header.
+struct WifiPacket {
+    enum class PacketType : u8 {
+        Beacon,
+        Data,
+        Authentication,
+        AssociationResponse,
+        Deauthentication,
+        NodeMap
+    };
+    PacketType type;      ///< The type of 802.11 frame.
+    std::vector<u8> data; ///< Raw 802.11 frame data, starting at the management frame header
+                          /// for management frames.
+    MacAddress transmitter_address; ///< Mac address of the transmitter.
+    MacAddress destination_address; ///< Mac address of the receiver.
+    u8 channel;                     ///< WiFi channel where this frame was transmitted.
+};
+
+/**
+ * A link that carries local wireless frames between emulated consoles. Frames sent to
+ * BroadcastMac are delivered to every other console on the link, other frames only to the console
+ * with the matching MAC address.
+ */
+class WifiTransport {
+public:
+    // The handle for the WiFi packet callback functions
+    using PacketCallbackHandle = std::shared_ptr<std::function<void(const WifiPacket&)>>;
+
+    virtual ~WifiTransport() = default;
+
+    /**
+     * Returns whether WiFi packets can currently be sent and received.
+     */
+    virtual bool IsJoined() const = 0;
+
+    /**
+     * Returns the MAC address of this console on the link.
+     */
+    virtual const MacAddress& GetMacAddress() const = 0;
+
+    /**
+     * Sends a WiFi packet to the other consoles on the link.
+     * @param packet The WiFi packet to send.
+     */
+    virtual void SendWifiPacket(const WifiPacket& packet) = 0;
+
+    /**
+     * Binds a function to an event that will be triggered every time a WifiPacket is received.
+     * The function wil be called everytime the event is triggered.
+     * The callback function must not bind or unbind a function. Doing so will cause a deadlock
+     * @param callback The function to call
+     * @return A handle used for removing the function from the registered list
+     */
+    virtual PacketCallbackHandle BindOnWifiPacketReceived(
+        std::function<void(const WifiPacket&)> callback) = 0;
+
+    /**
+     * Unbinds a function bound with BindOnWifiPacketReceived.
+     * @param handle The connection handle to disconnect
+     */
+    virtual void UnbindOnWifiPacketReceived(PacketCallbackHandle handle) = 0;
+};
+
+} // namespace Network
@@ -0,0 +1,126 @@
+// Copyright 2020 vvctre project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <fmt/format.h>
+#include "common/file_util.h"
+#include "common/logging/backend.h"
+#include "common/logging/filter.h"
+#include "common/logging/log.h"
+#include "common/texture_pack.h"
+
+// Converts a directory of tex1_[width]x[height]_[64-bit hash]_[format].[extension] custom textures
+// into a texture pack that vvctre loads from textures/[TitleID].vtpk
+//
+// Custom textures made before vvctre hashed textures from 3DS memory are named after the hash of
+// the decoded texture. vvctre writes the pairs of old and new hashes of the textures it used to
+// textures/[TitleID].hashmap in the dump directory, which can be passed with --hash-map to name
+// those textures after the new hashes in the pack. Once every texture is named after a new hash,
+// pass --source-hashes so vvctre stops trying the old hash of textures the pack doesn't replace.
+int main(int argc, char** argv) {
+    // TexturePack::Write logs the textures it skips
+    Log::Filter log_filter(Log::Level::Info);
+    Log::SetGlobalFilter(log_filter);
+    Log::AddBackend(std::make_unique<Log::ColorConsoleBackend>());
+
+    const char* program = argv[0];
+    std::string hash_map_path;
+    u32 flags = 0;
+    for (;;) {
+        if (argc > 2 && std::strcmp(argv[1], "--hash-map") == 0) {
+            hash_map_path = argv[2];
+            argv += 2;
+            argc -= 2;
+        } else if (argc > 1 && std::strcmp(argv[1], "--source-hashes") == 0) {
+            flags |= Common::TexturePack::SourceHashesFlag;
+            ++argv;
+            --argc;
+        } else {
+            break;
+        }
+    }
+
+    if (argc != 3) {
+        fmt::print(stderr,
+                   "Usage: {} [--hash-map <hash map>] [--source-hashes] <textures directory> "
+                   "<output file>\n",
+                   program);
+        return 1;
+    }
+
+    std::unordered_multimap<u64, u64> source_hashes;
+    if (!hash_map_path.empty()) {
+        std::FILE* hash_map = std::fopen(hash_map_path.c_str(), "r");
+        if (hash_map == nullptr) {
+            fmt::print(stderr, "Failed to open {}\n", hash_map_path);
+            return 1;
+        }
+        unsigned long long legacy_hash;
+        unsigned long long source_hash;
+        while (std::fscanf(hash_map, "%llX %llX", &legacy_hash, &source_hash) == 2) {
+            source_hashes.emplace(legacy_hash, source_hash);
+        }
+        std::fclose(hash_map);
+    }
+
+    FileUtil::FSTEntry texture_dir;
+    std::vector<FileUtil::FSTEntry> files;
+    // 64 nested folders should be plenty for most cases
+    FileUtil::ScanDirectoryTree(argv[1], texture_dir, 64);
+    FileUtil::GetAllFilesFromNestedEntries(texture_dir, files);
+
+    std::vector<Common::TexturePack::Texture> textures;
+    std::size_t renamed = 0;
+    for (const auto& file : files) {
+        if (file.isDirectory || file.virtualName.substr(0, 5) != "tex1_") {
+            continue;
+        }
+
+        Common::TexturePack::Texture texture;
+        unsigned long long hash;
+        if (std::sscanf(file.virtualName.c_str(), "tex1_%ux%u_%llX_%u.%*s", &texture.width,
+                        &texture.height, &hash, &texture.format) != 4) {
+            continue;
+        }
+        texture.hash = hash;
+
+        FileUtil::IOFile image(file.physicalName, "rb");
+        texture.data.resize(image.GetSize());
+        if (!image.IsOpen() || image.ReadBytes(texture.data.data(), texture.data.size()) !=
+                                   texture.data.size()) {
+            fmt::print(stderr, "Failed to read {}\n", file.physicalName);
+            return 1;
+        }
+
+        // The same decoded texture can come from several textures in 3DS memory
+        const auto [begin, end] = source_hashes.equal_range(hash);
+        if (begin == end) {
+            textures.push_back(std::move(texture));
+            continue;
+        }
+        for (auto it = begin; it != end; ++it) {
+            texture.hash = it->second;
+            textures.push_back(texture);
+        }
+        ++renamed;
+    }
+
+    const std::size_t count = textures.size();
+    if (!Common::TexturePack::Write(argv[2], std::move(textures), flags)) {
+        fmt::print(stderr, "Failed to write {}\n", argv[2]);
+        return 1;
+    }
+
+    fmt::print("Packed {} textures into {}", count, argv[2]);
+    if (!hash_map_path.empty()) {
+        fmt::print(", {} were renamed with the hash map", renamed);
+    }
+    fmt::print("\n");
+    return 0;
+}
@@ -21,6 +21,9 @@ public:
     /// Swap buffers (render frame)
     virtual void SwapBuffers() = 0;
 
+    /// Sends the frames that are still being read back to the frame dumper before it stops
+    virtual void FlushFrameDump() {}
+
     /// Updates the framebuffer layout of the contained render window handle.
     void UpdateCurrentFramebufferLayout();
 
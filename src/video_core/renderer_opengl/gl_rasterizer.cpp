@@ -12,6 +12,7 @@
 #include "common/assert.h"
 #include "common/logging/log.h"
 #include "common/math_util.h"
+#include "common/profiler.h"
 #include "common/scope_exit.h"
 #include "common/vector_math.h"
 #include "core/hw/gpu.h"
@@ -21,6 +22,7 @@
 #include "video_core/regs_texturing.h"
 #include "video_core/renderer_opengl/gl_rasterizer.h"
 #include "video_core/renderer_opengl/gl_shader_gen.h"
+#include "video_core/renderer_opengl/gl_vertex_buffer_cache.h"
 #include "video_core/renderer_opengl/pica_to_gl.h"
 #include "video_core/renderer_opengl/renderer_opengl.h"
 #include "video_core/video_core.h"
@@ -294,8 +296,9 @@ RasterizerOpenGL::VertexArrayInfo RasterizerOpenGL::AnalyzeVertexArray(bool is_i
     return {vertex_min, vertex_max, vs_input_size};
 }
 
-void RasterizerOpenGL::SetupVertexArray(u8* array_ptr, GLintptr buffer_offset,
-                                        GLuint vs_input_index_min, GLuint vs_input_index_max) {
+std::size_t RasterizerOpenGL::SetupVertexArray(u8* array_ptr, GLintptr buffer_offset,
+                                               GLuint vs_input_index_min,
+                                               GLuint vs_input_index_max) {
     const auto& regs = Pica::g_state.regs;
     const auto& vertex_attributes = regs.pipeline.vertex_attributes;
     PAddr base_address = vertex_attributes.GetPhysicalBaseAddress();
@@ -305,12 +308,27 @@ void RasterizerOpenGL::SetupVertexArray(u8* array_ptr, GLintptr buffer_offset,
     state.Apply();
 
     std::array<bool, 16> enable_attributes{};
+    std::size_t streamed_size = 0;
 
     for (const auto& loader : vertex_attributes.attribute_loaders) {
         if (loader.component_count == 0 || loader.byte_count == 0) {
             continue;
         }
 
+        PAddr data_addr =
+            base_address + loader.data_offset + (vs_input_index_min * loader.byte_count);
+
+        u32 vertex_num = vs_input_index_max - vs_input_index_min + 1;
+        u32 data_size = loader.byte_count * vertex_num;
+
+        res_cache.FlushRegion(data_addr, data_size, nullptr);
+
+        // Arrays that didn't change since earlier frames are in buffer objects of their own
+        const GLuint cached_buffer = res_cache.vertex_buffer_cache->Get(data_addr, data_size);
+        state.draw.vertex_buffer = cached_buffer != 0 ? cached_buffer : vertex_buffer.GetHandle();
+        state.Apply();
+        const GLintptr attribute_offset = cached_buffer != 0 ? 0 : buffer_offset;
+
         u32 offset = 0;
         for (u32 comp = 0; comp < loader.component_count && comp < 12; ++comp) {
             u32 attribute_index = loader.GetComponent(comp);
@@ -325,7 +343,7 @@ void RasterizerOpenGL::SetupVertexArray(u8* array_ptr, GLintptr buffer_offset,
                         vertex_attributes.GetFormat(attribute_index))];
                     GLsizei stride = loader.byte_count;
                     glVertexAttribPointer(input_reg, size, type, GL_FALSE, stride,
-                                          reinterpret_cast<GLvoid*>(buffer_offset + offset));
+                                          reinterpret_cast<GLvoid*>(attribute_offset + offset));
                     enable_attributes[input_reg] = true;
 
                     offset += vertex_attributes.GetStride(attribute_index);
@@ -338,19 +356,21 @@ void RasterizerOpenGL::SetupVertexArray(u8* array_ptr, GLintptr buffer_offset,
             }
         }
 
-        PAddr data_addr =
-            base_address + loader.data_offset + (vs_input_index_min * loader.byte_count);
-
-        u32 vertex_num = vs_input_index_max - vs_input_index_min + 1;
-        u32 data_size = loader.byte_count * vertex_num;
+        if (cached_buffer != 0) {
+            continue;
+        }
 
-        res_cache.FlushRegion(data_addr, data_size, nullptr);
         std::memcpy(array_ptr, VideoCore::g_memory->GetPhysicalPointer(data_addr), data_size);
 
         array_ptr += data_size;
         buffer_offset += data_size;
+        streamed_size += data_size;
     }
 
+    // The stream buffer must be bound again to be unmapped
+    state.draw.vertex_buffer = vertex_buffer.GetHandle();
+    state.Apply();
+
     for (std::size_t i = 0; i < enable_attributes.size(); ++i) {
         if (enable_attributes[i] != hw_vao_enabled_attributes[i]) {
             if (enable_attributes[i]) {
@@ -370,11 +390,16 @@ void RasterizerOpenGL::SetupVertexArray(u8* array_ptr, GLintptr buffer_offset,
             }
         }
     }
+
+    res_cache.vertex_buffer_cache->AddUploadedBytes(streamed_size);
+    return streamed_size;
 }
 
 bool RasterizerOpenGL::SetupVertexShader() {
-    return shader_program_manager->UseProgrammableVertexShader(Pica::g_state.regs,
-                                                               Pica::g_state.vs);
+    const bool succeeded = shader_program_manager->UseProgrammableVertexShader(
+        Pica::g_state.regs, Pica::g_state.vs, vs_dirty);
+    vs_dirty = false;
+    return succeeded;
 }
 
 bool RasterizerOpenGL::SetupGeometryShader() {
@@ -385,7 +410,8 @@ bool RasterizerOpenGL::SetupGeometryShader() {
         return false;
     }
 
-    shader_program_manager->UseFixedGeometryShader(regs);
+    shader_program_manager->UseFixedGeometryShader(regs, gs_dirty);
+    gs_dirty = false;
     return true;
 }
 
@@ -439,8 +465,9 @@ bool RasterizerOpenGL::AccelerateDrawBatchInternal(bool is_indexed) {
     u8* buffer_ptr;
     GLintptr buffer_offset;
     std::tie(buffer_ptr, buffer_offset, std::ignore) = vertex_buffer.Map(vs_input_size, 4);
-    SetupVertexArray(buffer_ptr, buffer_offset, vs_input_index_min, vs_input_index_max);
-    vertex_buffer.Unmap(vs_input_size);
+    const std::size_t streamed_size =
+        SetupVertexArray(buffer_ptr, buffer_offset, vs_input_index_min, vs_input_index_max);
+    vertex_buffer.Unmap(streamed_size);
 
     shader_program_manager->ApplyTo(state);
     state.Apply();
@@ -454,17 +481,31 @@ bool RasterizerOpenGL::AccelerateDrawBatchInternal(bool is_indexed) {
             return false;
         }
 
-        const u8* index_data = VideoCore::g_memory->GetPhysicalPointer(
-            regs.pipeline.vertex_attributes.GetPhysicalBaseAddress() +
-            regs.pipeline.index_array.offset);
-        std::tie(buffer_ptr, buffer_offset, std::ignore) = index_buffer.Map(index_buffer_size, 4);
-        std::memcpy(buffer_ptr, index_data, index_buffer_size);
-        index_buffer.Unmap(index_buffer_size);
+        const PAddr index_addr = regs.pipeline.vertex_attributes.GetPhysicalBaseAddress() +
+                                 regs.pipeline.index_array.offset;
+        const GLuint cached_buffer =
+            res_cache.vertex_buffer_cache->Get(index_addr, static_cast<u32>(index_buffer_size));
+        if (cached_buffer != 0) {
+            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, cached_buffer);
+            buffer_offset = 0;
+        } else {
+            const u8* index_data = VideoCore::g_memory->GetPhysicalPointer(index_addr);
+            std::tie(buffer_ptr, buffer_offset, std::ignore) =
+                index_buffer.Map(index_buffer_size, 4);
+            std::memcpy(buffer_ptr, index_data, index_buffer_size);
+            index_buffer.Unmap(index_buffer_size);
+            res_cache.vertex_buffer_cache->AddUploadedBytes(index_buffer_size);
+        }
 
         glDrawRangeElementsBaseVertex(
             primitive_mode, vs_input_index_min, vs_input_index_max, regs.pipeline.num_vertices,
             index_u16 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_BYTE,
             reinterpret_cast<const void*>(buffer_offset), -static_cast<GLint>(vs_input_index_min));
+
+        if (cached_buffer != 0) {
+            // The index stream buffer is mapped through the vertex array's binding
+            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, index_buffer.GetHandle());
+        }
     } else {
         glDrawArrays(primitive_mode, 0, regs.pipeline.num_vertices);
     }
@@ -479,6 +520,8 @@ void RasterizerOpenGL::DrawTriangles() {
 }
 
 bool RasterizerOpenGL::Draw(bool accelerate, bool is_indexed) {
+    Common::Profiler::ScopedTimer timer{"GPU", "Draw"};
+
     const Pica::Regs& regs = Pica::g_state.regs;
 
     bool shadow_rendering = regs.framebuffer.output_merger.fragment_operation_mode ==
@@ -881,8 +924,10 @@ void RasterizerOpenGL::NotifyPicaRegisterChanged(u32 id) {
         break;
 
         // Blending
+        // (This register also contains the fragment operation mode)
     case PICA_REG_INDEX(framebuffer.output_merger.alphablend_enable):
         SyncBlendEnabled();
+        shader_dirty = true;
         break;
     case PICA_REG_INDEX(framebuffer.output_merger.alpha_blending):
         SyncBlendFuncs();
@@ -894,6 +939,7 @@ void RasterizerOpenGL::NotifyPicaRegisterChanged(u32 id) {
         // Shadow texture
     case PICA_REG_INDEX(texturing.shadow):
         SyncShadowTextureBias();
+        shader_dirty = true;
         break;
 
         // Fog state
@@ -1076,6 +1122,7 @@ void RasterizerOpenGL::NotifyPicaRegisterChanged(u32 id) {
     case PICA_REG_INDEX(lighting.lut_input):
     case PICA_REG_INDEX(lighting.lut_scale):
     case PICA_REG_INDEX(lighting.light_enable):
+        shader_dirty = true;
         break;
 
         // Fragment lighting specular 0 color
@@ -1333,6 +1380,43 @@ void RasterizerOpenGL::NotifyPicaRegisterChanged(u32 id) {
         uniform_block_data.lighting_lut_dirty_any = true;
         break;
     }
+
+        // Vertex shader program
+    case PICA_REG_INDEX(vs.main_offset):
+    case PICA_REG_INDEX(vs.program.set_word[0]):
+    case PICA_REG_INDEX(vs.program.set_word[1]):
+    case PICA_REG_INDEX(vs.program.set_word[2]):
+    case PICA_REG_INDEX(vs.program.set_word[3]):
+    case PICA_REG_INDEX(vs.program.set_word[4]):
+    case PICA_REG_INDEX(vs.program.set_word[5]):
+    case PICA_REG_INDEX(vs.program.set_word[6]):
+    case PICA_REG_INDEX(vs.program.set_word[7]):
+    case PICA_REG_INDEX(vs.swizzle_patterns.set_word[0]):
+    case PICA_REG_INDEX(vs.swizzle_patterns.set_word[1]):
+    case PICA_REG_INDEX(vs.swizzle_patterns.set_word[2]):
+    case PICA_REG_INDEX(vs.swizzle_patterns.set_word[3]):
+    case PICA_REG_INDEX(vs.swizzle_patterns.set_word[4]):
+    case PICA_REG_INDEX(vs.swizzle_patterns.set_word[5]):
+    case PICA_REG_INDEX(vs.swizzle_patterns.set_word[6]):
+    case PICA_REG_INDEX(vs.swizzle_patterns.set_word[7]):
+        vs_dirty = true;
+        break;
+
+        // Vertex shader outputs
+    case PICA_REG_INDEX(vs.output_mask):
+        vs_dirty = true;
+        gs_dirty = true;
+        break;
+    case PICA_REG_INDEX(rasterizer.vs_output_total):
+    case PICA_REG_INDEX(rasterizer.vs_output_attributes[0]):
+    case PICA_REG_INDEX(rasterizer.vs_output_attributes[1]):
+    case PICA_REG_INDEX(rasterizer.vs_output_attributes[2]):
+    case PICA_REG_INDEX(rasterizer.vs_output_attributes[3]):
+    case PICA_REG_INDEX(rasterizer.vs_output_attributes[4]):
+    case PICA_REG_INDEX(rasterizer.vs_output_attributes[5]):
+    case PICA_REG_INDEX(rasterizer.vs_output_attributes[6]):
+        gs_dirty = true;
+        break;
     }
 }
 
@@ -1353,6 +1437,10 @@ void RasterizerOpenGL::FlushAndInvalidateRegion(PAddr addr, u32 size) {
     res_cache.InvalidateRegion(addr, size, nullptr);
 }
 
+void RasterizerOpenGL::EndFrame() {
+    res_cache.EndFrame();
+}
+
 bool RasterizerOpenGL::AccelerateDisplayTransfer(const GPU::Regs::DisplayTransferConfig& config) {
     SurfaceParams src_params;
     src_params.addr = config.GetPhysicalInputAddress();
@@ -50,6 +50,7 @@ public:
     void FlushRegion(PAddr addr, u32 size) override;
     void InvalidateRegion(PAddr addr, u32 size) override;
     void FlushAndInvalidateRegion(PAddr addr, u32 size) override;
+    void EndFrame() override;
     bool AccelerateDisplayTransfer(const GPU::Regs::DisplayTransferConfig& config) override;
     bool AccelerateTextureCopy(const GPU::Regs::DisplayTransferConfig& config) override;
     bool AccelerateFill(const GPU::Regs::MemoryFillConfig& config) override;
@@ -250,8 +251,9 @@ private:
     VertexArrayInfo AnalyzeVertexArray(bool is_indexed);
 
     /// Setup vertex array for AccelerateDrawBatch
-    void SetupVertexArray(u8* array_ptr, GLintptr buffer_offset, GLuint vs_input_index_min,
-                          GLuint vs_input_index_max);
+    /// Returns the number of bytes written to array_ptr
+    std::size_t SetupVertexArray(u8* array_ptr, GLintptr buffer_offset,
+                                 GLuint vs_input_index_min, GLuint vs_input_index_max);
 
     /// Setup vertex shader for AccelerateDrawBatch
     bool SetupVertexShader();
@@ -268,8 +270,15 @@ private:
 
     std::vector<HardwareVertex> vertex_batch;
 
+    /// Set when registers read by PicaFSConfig::BuildFromRegs change
     bool shader_dirty = true;
 
+    /// Set when registers or program data read by PicaVSConfig change
+    bool vs_dirty = true;
+
+    /// Set when registers read by PicaFixedGSConfig change
+    bool gs_dirty = true;
+
     struct {
         UniformData data;
         std::array<bool, Pica::LightingRegs::NumLightingSampler> lighting_lut_dirty;
@@ -16,12 +16,13 @@
 #include <boost/range/iterator_range.hpp>
 #include <glad/glad.h>
 #include <stb_image.h>
-#include <stb_image_write.h>
 #include "common/alignment.h"
 #include "common/bit_field.h"
 #include "common/color.h"
+#include "common/hash.h"
 #include "common/logging/log.h"
 #include "common/math_util.h"
+#include "common/profiler.h"
 #include "common/scope_exit.h"
 #include "common/texture.h"
 #include "common/vector_math.h"
@@ -36,6 +37,8 @@
 #include "video_core/renderer_opengl/gl_format_reinterpreter.h"
 #include "video_core/renderer_opengl/gl_rasterizer_cache.h"
 #include "video_core/renderer_opengl/gl_state.h"
+#include "video_core/renderer_opengl/gl_texture_dumper.h"
+#include "video_core/renderer_opengl/gl_vertex_buffer_cache.h"
 #include "video_core/renderer_opengl/texture_filters/texture_filterer.h"
 #include "video_core/utils.h"
 #include "video_core/video_core.h"
@@ -73,69 +76,6 @@ const FormatTuple& GetFormatTuple(PixelFormat pixel_format) {
     return tex_tuple;
 }
 
-/**
- * Hack: obtain the pixels by attaching the texture to a framebuffer.
- * Originally from https://github.com/apitrace/apitrace/blob/master/retrace/glstate_images.cpp
- */
-static void GetTexImage(GLenum target, GLint level, GLenum format, GLenum type, GLint height,
-                        GLint width, GLint depth, GLubyte* pixels, std::size_t size) {
-    std::memset(pixels, 0x80, size);
-
-    OpenGLState cur_state = OpenGLState::GetCurState();
-    OpenGLState state;
-
-    GLenum texture_binding = GL_NONE;
-    switch (target) {
-    case GL_TEXTURE_2D:
-        texture_binding = GL_TEXTURE_BINDING_2D;
-        break;
-    case GL_TEXTURE_CUBE_MAP_POSITIVE_X:
-    case GL_TEXTURE_CUBE_MAP_NEGATIVE_X:
-    case GL_TEXTURE_CUBE_MAP_POSITIVE_Y:
-    case GL_TEXTURE_CUBE_MAP_NEGATIVE_Y:
-    case GL_TEXTURE_CUBE_MAP_POSITIVE_Z:
-    case GL_TEXTURE_CUBE_MAP_NEGATIVE_Z:
-        texture_binding = GL_TEXTURE_BINDING_CUBE_MAP;
-        break;
-    default:
-        return;
-    }
-
-    GLint texture = 0;
-    glGetIntegerv(texture_binding, &texture);
-    if (!texture) {
-        return;
-    }
-
-    OGLFramebuffer fbo;
-    fbo.Create();
-    state.draw.read_framebuffer = fbo.handle;
-    state.Apply();
-
-    switch (target) {
-    case GL_TEXTURE_2D:
-    case GL_TEXTURE_CUBE_MAP_POSITIVE_X:
-    case GL_TEXTURE_CUBE_MAP_NEGATIVE_X:
-    case GL_TEXTURE_CUBE_MAP_POSITIVE_Y:
-    case GL_TEXTURE_CUBE_MAP_NEGATIVE_Y:
-    case GL_TEXTURE_CUBE_MAP_POSITIVE_Z:
-    case GL_TEXTURE_CUBE_MAP_NEGATIVE_Z: {
-        glFramebufferTexture2D(GL_READ_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, texture,
-                               level);
-        GLenum status = glCheckFramebufferStatus(GL_READ_FRAMEBUFFER);
-        if (status != GL_FRAMEBUFFER_COMPLETE) {
-            LOG_DEBUG(Render_OpenGL, "Framebuffer is incomplete, status: {:X}", status);
-        }
-        glReadPixels(0, 0, width, height, format, type, pixels);
-        break;
-    }
-    }
-
-    cur_state.Apply();
-
-    fbo.Release();
-}
-
 template <typename Map, typename Interval>
 static constexpr auto RangeFromInterval(Map& map, const Interval& interval) {
     return boost::make_iterator_range(map.equal_range(interval));
@@ -535,13 +475,22 @@ void RasterizerCacheOpenGL::CopySurface(const Surface& src_surface, const Surfac
 void CachedSurface::LoadGLBuffer(PAddr load_start, PAddr load_end) {
     ASSERT(type != SurfaceType::Fill);
 
+    // The buffer is kept until the surface is evicted, so later partial loads reuse it
+    if (gl_buffer.empty()) {
+        gl_buffer.resize(width * height * GetGLBytesPerPixel(pixel_format));
+    }
+
     const u8* const texture_src_data = VideoCore::g_memory->GetPhysicalPointer(addr);
     if (texture_src_data == nullptr) {
         return;
     }
 
-    if (gl_buffer.empty()) {
-        gl_buffer.resize(width * height * GetGLBytesPerPixel(pixel_format));
+    // The custom texture replaces the whole surface, so the original doesn't need to be decoded
+    if (Settings::values.custom_textures) {
+        custom_tex_info = LoadCustomTexture(GetSourceHash());
+        if (custom_tex_info) {
+            return;
+        }
     }
 
     // TODO: Should probably be done in ::Memory:: and check for other regions too
@@ -633,41 +582,47 @@ void CachedSurface::FlushGLBuffer(PAddr flush_start, PAddr flush_end) {
     }
 }
 
-bool CachedSurface::LoadCustomTexture(u64 tex_hash) {
+u64 CachedSurface::GetSourceHash() {
+    if (source_hash) {
+        return *source_hash;
+    }
+
+    const u8* const data = VideoCore::g_memory->GetPhysicalPointer(addr);
+    if (data == nullptr) {
+        return 0;
+    }
+
+    PAddr hash_end = end;
+    if (addr < Memory::VRAM_PADDR_END && end > Memory::VRAM_PADDR_END) {
+        hash_end = Memory::VRAM_PADDR_END;
+    }
+
+    // The size and format are part of the hash, as the same data can be used for different
+    // textures
+    source_hash = Common::CityHash64WithSeeds(reinterpret_cast<const char*>(data), hash_end - addr,
+                                              static_cast<u64>(width) << 32 | height,
+                                              static_cast<u64>(pixel_format));
+    return *source_hash;
+}
+
+std::shared_ptr<const Core::CustomTexInfo> CachedSurface::LoadCustomTexture(u64 tex_hash) {
     Core::CustomTexCache& custom_tex_cache = Core::System::GetInstance().CustomTexCache();
+    if (!custom_tex_cache.CustomTextureExists(tex_hash)) {
+        custom_pending = false;
+        return nullptr;
+    }
 
-    if (custom_tex_cache.IsTextureCached(tex_hash)) {
-        custom_tex_info = custom_tex_cache.LookupTexture(tex_hash);
-        return true;
-    } else if (custom_tex_cache.CustomTextureExists(tex_hash)) {
-        const Core::CustomTexPathInfo& path_info = custom_tex_cache.LookupTexturePathInfo(tex_hash);
-        unsigned char* image =
-            stbi_load(path_info.path.c_str(), reinterpret_cast<int*>(&custom_tex_info.width),
-                      reinterpret_cast<int*>(&custom_tex_info.height), nullptr, 4);
-        if (image != nullptr) {
-            custom_tex_info.tex.resize(custom_tex_info.width * custom_tex_info.height * 4);
-            std::memcpy(custom_tex_info.tex.data(), image, custom_tex_info.tex.size());
-            free(image);
-
-            // Make sure the texture size is a power of 2
-            std::bitset<32> width_bits(custom_tex_info.width);
-            std::bitset<32> height_bits(custom_tex_info.height);
-            if (width_bits.count() == 1 && height_bits.count() == 1) {
-                LOG_DEBUG(Render_OpenGL, "Loaded custom texture from {}", path_info.path);
-                Common::FlipRGBA8Texture(custom_tex_info.tex, custom_tex_info.width,
-                                         custom_tex_info.height);
-                custom_tex_cache.CacheTexture(path_info.hash, custom_tex_info.tex,
-                                              custom_tex_info.width, custom_tex_info.height);
-                return true;
-            } else {
-                LOG_ERROR(Render_OpenGL, "Texture {} size is not a power of 2", path_info.path);
-            }
-        } else {
-            LOG_ERROR(Render_OpenGL, "Failed to load custom texture {}", path_info.path);
-        }
+    std::shared_ptr<const Core::CustomTexInfo> custom_tex_info =
+        custom_tex_cache.GetTexture(tex_hash);
+    if (custom_tex_info) {
+        custom_width = custom_tex_info->width;
+        custom_height = custom_tex_info->height;
     }
 
-    return false;
+    // If it's still being decoded, the original texture is used until the cache swaps it in
+    custom_pending = !custom_tex_info && !custom_tex_cache.HasTextureFailed(tex_hash);
+    custom_hash = tex_hash;
+    return custom_tex_info;
 }
 
 void CachedSurface::DumpTexture(GLuint target_tex, u64 tex_hash) {
@@ -677,44 +632,14 @@ void CachedSurface::DumpTexture(GLuint target_tex, u64 tex_hash) {
     std::bitset<32> height_bits(height);
 
     if (width_bits.count() == 1 && height_bits.count() == 1) {
-        // Dump texture to RGBA8 and encode as PNG
-        auto& custom_tex_cache = Core::System::GetInstance().CustomTexCache();
-        std::string dump_path = fmt::format(
-            "{}textures/{:016X}/", FileUtil::GetUserPath(FileUtil::UserPath::DumpDir),
-            Core::System::GetInstance().Kernel().GetCurrentProcess()->codeset->program_id);
-        if (!FileUtil::CreateFullPath(dump_path)) {
-            LOG_ERROR(Render, "Unable to create {}", dump_path);
-            return;
+        if (!owner.texture_dumper) {
+            owner.texture_dumper = std::make_unique<TextureDumper>(
+                Core::System::GetInstance().Kernel().GetCurrentProcess()->codeset->program_id);
         }
 
-        dump_path += fmt::format("tex1_{}x{}_{:016X}_{}.png", width, height, tex_hash,
-                                 static_cast<u32>(pixel_format));
-        if (!custom_tex_cache.IsTextureDumped(tex_hash) && !FileUtil::Exists(dump_path)) {
-            custom_tex_cache.SetTextureDumped(tex_hash);
-
-            LOG_INFO(Render_OpenGL, "Dumping texture to {}", dump_path);
-            std::vector<u8> decoded_texture;
-            decoded_texture.resize(width * height * 4);
-            glBindTexture(GL_TEXTURE_2D, target_tex);
-            /*
-               GetTexImage is used to work around a small issue that
-               happens if using custom textures with texture dumping at the same.
-               Let's say there's 2 textures that are both 32x32 and one of them gets replaced with a
-               higher quality 256x256 texture. If the 256x256 texture is displayed first and the
-               32x32 texture gets uploaded to the same underlying OpenGL texture, the 32x32 texture
-               will appear in the corner of the 256x256 texture. If texture dumping is enabled and
-               the 32x32 is undumped, vvctre will attempt to dump it. Since the underlying OpenGL
-               texture is still 256x256, vvctre crashes because it thinks the texture is only 32x32.
-               GetTexImage conveniently only dumps the specified region.
-            */
-            GetTexImage(GL_TEXTURE_2D, 0, GL_RGBA, GL_UNSIGNED_BYTE, height, width, 0,
-                        &decoded_texture[0], decoded_texture.size());
-            glBindTexture(GL_TEXTURE_2D, 0);
-            Common::FlipRGBA8Texture(decoded_texture, width, height);
-            if (stbi_write_png(dump_path.c_str(), static_cast<int>(width), static_cast<int>(height),
-                               4, decoded_texture.data(), static_cast<int>(width) * 4) == 0) {
-                LOG_ERROR(Render_OpenGL, "Failed to save decoded texture");
-            }
+        if (!owner.texture_dumper->IsDumped(tex_hash)) {
+            owner.texture_dumper->Dump(target_tex, width, height, tex_hash,
+                                       static_cast<u32>(pixel_format));
         }
     } else {
         LOG_WARNING(Render_OpenGL, "Not dumping {:016X} because size isn't a power of 2 ({}x{})",
@@ -733,11 +658,23 @@ void CachedSurface::UploadGLTexture(Common::Rectangle<u32> rect, GLuint read_fb_
     u64 tex_hash = 0;
 
     if (Settings::values.dump_textures || Settings::values.custom_textures) {
-        tex_hash = Common::ComputeHash64(gl_buffer.data(), gl_buffer.size());
+        tex_hash = GetSourceHash();
     }
 
     if (Settings::values.custom_textures) {
-        is_custom = LoadCustomTexture(tex_hash);
+        Core::CustomTexCache& custom_tex_cache = Core::System::GetInstance().CustomTexCache();
+        if (!custom_tex_info && !custom_pending && custom_tex_cache.NeedsLegacyHash(tex_hash)) {
+            // Custom textures made before textures were hashed from 3DS memory are named after
+            // the hash of the decoded texture
+            const u64 legacy_hash = Common::ComputeHash64(gl_buffer.data(), gl_buffer.size());
+            custom_tex_info = LoadCustomTexture(legacy_hash);
+            if (custom_tex_info || custom_pending) {
+                custom_tex_cache.MapLegacyHash(legacy_hash, tex_hash);
+            } else {
+                custom_tex_cache.AddLegacyHashMiss(tex_hash);
+            }
+        }
+        is_custom = custom_tex_info != nullptr;
     }
 
     // Load data from memory to the surface
@@ -758,7 +695,7 @@ void CachedSurface::UploadGLTexture(Common::Rectangle<u32> rect, GLuint read_fb_
         unscaled_tex.Create();
         if (is_custom) {
             AllocateSurfaceTexture(unscaled_tex.handle, GetFormatTuple(PixelFormat::RGBA8),
-                                   custom_tex_info.width, custom_tex_info.height);
+                                   custom_tex_info->width, custom_tex_info->height);
         } else {
             AllocateSurfaceTexture(unscaled_tex.handle, tuple, rect.GetWidth(), rect.GetHeight());
         }
@@ -776,17 +713,17 @@ void CachedSurface::UploadGLTexture(Common::Rectangle<u32> rect, GLuint read_fb_
     if (is_custom) {
         if (res_scale == 1) {
             AllocateSurfaceTexture(texture.handle, GetFormatTuple(PixelFormat::RGBA8),
-                                   custom_tex_info.width, custom_tex_info.height);
+                                   custom_tex_info->width, custom_tex_info->height);
             cur_state.texture_units[0].texture_2d = texture.handle;
             cur_state.Apply();
         }
 
         // Always going to be using RGBA8
-        glPixelStorei(GL_UNPACK_ROW_LENGTH, static_cast<GLint>(custom_tex_info.width));
+        glPixelStorei(GL_UNPACK_ROW_LENGTH, static_cast<GLint>(custom_tex_info->width));
 
         glActiveTexture(GL_TEXTURE0);
-        glTexSubImage2D(GL_TEXTURE_2D, 0, x0, y0, custom_tex_info.width, custom_tex_info.height,
-                        GL_RGBA, GL_UNSIGNED_BYTE, custom_tex_info.tex.data());
+        glTexSubImage2D(GL_TEXTURE_2D, 0, x0, y0, custom_tex_info->width, custom_tex_info->height,
+                        GL_RGBA, GL_UNSIGNED_BYTE, custom_tex_info->tex.data());
     } else {
         glPixelStorei(GL_UNPACK_ROW_LENGTH, static_cast<GLint>(stride));
 
@@ -797,7 +734,7 @@ void CachedSurface::UploadGLTexture(Common::Rectangle<u32> rect, GLuint read_fb_
     }
 
     glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
-    if (Settings::values.dump_textures && !is_custom) {
+    if (Settings::values.dump_textures && !is_custom && !custom_pending) {
         DumpTexture(target_tex, tex_hash);
     }
 
@@ -811,18 +748,48 @@ void CachedSurface::UploadGLTexture(Common::Rectangle<u32> rect, GLuint read_fb_
         scaled_rect.right *= res_scale;
         scaled_rect.bottom *= res_scale;
         auto from_rect =
-            is_custom ? Common::Rectangle<u32>{0, custom_tex_info.height, custom_tex_info.width, 0}
+            is_custom ? Common::Rectangle<u32>{0, custom_height, custom_width, 0}
                       : Common::Rectangle<u32>{0, rect.GetHeight(), rect.GetWidth(), 0};
+        // Results for whole surfaces are cached by their content
+        const bool whole_surface = rect.left == 0 && rect.bottom == 0 &&
+                                   rect.GetWidth() == width && rect.GetHeight() == height;
+        const u64 filter_hash =
+            whole_surface && !is_custom && !custom_pending && !owner.texture_filterer->IsNull()
+                ? GetSourceHash()
+                : 0;
         if (!owner.texture_filterer->Filter(unscaled_tex.handle, from_rect, texture.handle,
-                                            scaled_rect, type, read_fb_handle, draw_fb_handle)) {
+                                            scaled_rect, type, read_fb_handle, draw_fb_handle,
+                                            filter_hash)) {
             BlitTextures(unscaled_tex.handle, from_rect, texture.handle, scaled_rect, type,
                          read_fb_handle, draw_fb_handle);
         }
     }
 
+    custom_tex_info.reset();
     InvalidateAllWatcher();
 }
 
+std::size_t CachedSurface::GetMemoryUsage() const {
+    if (type == SurfaceType::Fill) {
+        return 0;
+    }
+
+    std::size_t usage;
+    if (is_custom) {
+        usage = static_cast<std::size_t>(custom_width) * custom_height * 4;
+    } else {
+        usage = static_cast<std::size_t>(GetScaledWidth()) * GetScaledHeight() *
+                GetGLBytesPerPixel(pixel_format);
+    }
+
+    // A full mipmap chain adds a third
+    if (max_level != 0) {
+        usage += usage / 3;
+    }
+
+    return usage + gl_buffer.size();
+}
+
 void CachedSurface::DownloadGLTexture(const Common::Rectangle<u32>& rect, GLuint read_fb_handle,
                                       GLuint draw_fb_handle) {
     if (type == SurfaceType::Fill) {
@@ -929,6 +896,48 @@ void CachedSurface::DownloadGLTexture(const Common::Rectangle<u32>& rect, GLuint
     glPixelStorei(GL_PACK_ROW_LENGTH, 0);
 }
 
+void SurfaceIndex::Add(const Surface& surface) {
+    const u32 first_page = surface->addr >> PAGE_BITS;
+    const u32 last_page = (surface->end - 1) >> PAGE_BITS;
+    for (u32 page = first_page; page <= last_page; ++page) {
+        buckets[page].push_back(surface);
+    }
+
+    if (surface->pixel_format != SurfaceParams::PixelFormat::Invalid) {
+        exact_buckets[ExactKey(*surface)].push_back(surface);
+    }
+}
+
+void SurfaceIndex::Remove(const Surface& surface) {
+    const auto remove_from = [&surface](auto& map, const auto& key) {
+        const auto it = map.find(key);
+        if (it == map.end()) {
+            return;
+        }
+        SurfaceBucket& bucket = it->second;
+        bucket.erase(std::remove(bucket.begin(), bucket.end(), surface), bucket.end());
+        if (bucket.empty()) {
+            map.erase(it);
+        }
+    };
+
+    const u32 first_page = surface->addr >> PAGE_BITS;
+    const u32 last_page = (surface->end - 1) >> PAGE_BITS;
+    for (u32 page = first_page; page <= last_page; ++page) {
+        remove_from(buckets, page);
+    }
+
+    if (surface->pixel_format != SurfaceParams::PixelFormat::Invalid) {
+        remove_from(exact_buckets, ExactKey(*surface));
+    }
+}
+
+const SurfaceBucket& SurfaceIndex::FindExact(const SurfaceParams& params) const {
+    static const SurfaceBucket empty_bucket;
+    const auto it = exact_buckets.find(ExactKey(params));
+    return it == exact_buckets.end() ? empty_bucket : it->second;
+}
+
 enum MatchFlags {
     Invalid = 1,      // Flag that can be applied to other match types, invalid matches require
                       // validation before they can be used
@@ -945,7 +954,7 @@ static constexpr MatchFlags operator|(MatchFlags lhs, MatchFlags rhs) {
 
 /// Get the best surface match (and its match type) for the given flags
 template <MatchFlags find_flags>
-static Surface FindMatch(const SurfaceCache& surface_cache, const SurfaceParams& params,
+static Surface FindMatch(const SurfaceIndex& surface_index, const SurfaceParams& params,
                          ScaleMatch match_scale_type,
                          std::optional<SurfaceInterval> validate_interval = std::nullopt) {
     Surface match_surface = nullptr;
@@ -953,81 +962,88 @@ static Surface FindMatch(const SurfaceCache& surface_cache, const SurfaceParams&
     u32 match_scale = 0;
     SurfaceInterval match_interval{};
 
-    for (const auto& pair : RangeFromInterval(surface_cache, params.GetInterval())) {
-        for (const auto& surface : pair.second) {
-            const bool res_scale_matched = match_scale_type == ScaleMatch::Exact
-                                               ? (params.res_scale == surface->res_scale)
-                                               : (params.res_scale <= surface->res_scale);
-            // validity will be checked in GetCopyableInterval
-            bool is_valid =
-                find_flags & MatchFlags::Copy
-                    ? true
-                    : surface->IsRegionValid(validate_interval.value_or(params.GetInterval()));
-
-            if (!(find_flags & MatchFlags::Invalid) && !is_valid)
-                continue;
+    const auto check_surface = [&](const Surface& surface) {
+        const bool res_scale_matched = match_scale_type == ScaleMatch::Exact
+                                           ? (params.res_scale == surface->res_scale)
+                                           : (params.res_scale <= surface->res_scale);
+        // validity will be checked in GetCopyableInterval
+        bool is_valid =
+            find_flags & MatchFlags::Copy
+                ? true
+                : surface->IsRegionValid(validate_interval.value_or(params.GetInterval()));
+
+        if (!(find_flags & MatchFlags::Invalid) && !is_valid)
+            return;
 
-            auto IsMatch_Helper = [&](auto check_type, auto match_fn) {
-                if (!(find_flags & check_type))
-                    return;
-
-                bool matched;
-                SurfaceInterval surface_interval;
-                std::tie(matched, surface_interval) = match_fn();
-                if (!matched)
-                    return;
-
-                if (!res_scale_matched && match_scale_type != ScaleMatch::Ignore &&
-                    surface->type != SurfaceType::Fill)
-                    return;
-
-                // Found a match, update only if this is better than the previous one
-                auto UpdateMatch = [&] {
-                    match_surface = surface;
-                    match_valid = is_valid;
-                    match_scale = surface->res_scale;
-                    match_interval = surface_interval;
-                };
-
-                if (surface->res_scale > match_scale) {
-                    UpdateMatch();
-                    return;
-                } else if (surface->res_scale < match_scale) {
-                    return;
-                }
+        auto IsMatch_Helper = [&](auto check_type, auto match_fn) {
+            if (!(find_flags & check_type))
+                return;
+
+            bool matched;
+            SurfaceInterval surface_interval;
+            std::tie(matched, surface_interval) = match_fn();
+            if (!matched)
+                return;
+
+            if (!res_scale_matched && match_scale_type != ScaleMatch::Ignore &&
+                surface->type != SurfaceType::Fill)
+                return;
+
+            // Found a match, update only if this is better than the previous one
+            auto UpdateMatch = [&] {
+                match_surface = surface;
+                match_valid = is_valid;
+                match_scale = surface->res_scale;
+                match_interval = surface_interval;
+            };
 
-                if (is_valid && !match_valid) {
-                    UpdateMatch();
-                    return;
-                } else if (is_valid != match_valid) {
-                    return;
-                }
+            if (surface->res_scale > match_scale) {
+                UpdateMatch();
+                return;
+            } else if (surface->res_scale < match_scale) {
+                return;
+            }
 
-                if (boost::icl::length(surface_interval) > boost::icl::length(match_interval)) {
-                    UpdateMatch();
-                }
-            };
-            IsMatch_Helper(std::integral_constant<MatchFlags, MatchFlags::Exact>{}, [&] {
-                return std::make_pair(surface->ExactMatch(params), surface->GetInterval());
-            });
-            IsMatch_Helper(std::integral_constant<MatchFlags, MatchFlags::SubRect>{}, [&] {
-                return std::make_pair(surface->CanSubRect(params), surface->GetInterval());
-            });
-            IsMatch_Helper(std::integral_constant<MatchFlags, MatchFlags::Copy>{}, [&] {
-                ASSERT(validate_interval);
-                auto copy_interval =
-                    params.FromInterval(*validate_interval).GetCopyableInterval(surface);
-                bool matched = boost::icl::length(copy_interval & *validate_interval) != 0 &&
-                               surface->CanCopy(params, copy_interval);
-                return std::make_pair(matched, copy_interval);
-            });
-            IsMatch_Helper(std::integral_constant<MatchFlags, MatchFlags::Expand>{}, [&] {
-                return std::make_pair(surface->CanExpand(params), surface->GetInterval());
-            });
-            IsMatch_Helper(std::integral_constant<MatchFlags, MatchFlags::TexCopy>{}, [&] {
-                return std::make_pair(surface->CanTexCopy(params), surface->GetInterval());
-            });
+            if (is_valid && !match_valid) {
+                UpdateMatch();
+                return;
+            } else if (is_valid != match_valid) {
+                return;
+            }
+
+            if (boost::icl::length(surface_interval) > boost::icl::length(match_interval)) {
+                UpdateMatch();
+            }
+        };
+        IsMatch_Helper(std::integral_constant<MatchFlags, MatchFlags::Exact>{}, [&] {
+            return std::make_pair(surface->ExactMatch(params), surface->GetInterval());
+        });
+        IsMatch_Helper(std::integral_constant<MatchFlags, MatchFlags::SubRect>{}, [&] {
+            return std::make_pair(surface->CanSubRect(params), surface->GetInterval());
+        });
+        IsMatch_Helper(std::integral_constant<MatchFlags, MatchFlags::Copy>{}, [&] {
+            ASSERT(validate_interval);
+            auto copy_interval =
+                params.FromInterval(*validate_interval).GetCopyableInterval(surface);
+            bool matched = boost::icl::length(copy_interval & *validate_interval) != 0 &&
+                           surface->CanCopy(params, copy_interval);
+            return std::make_pair(matched, copy_interval);
+        });
+        IsMatch_Helper(std::integral_constant<MatchFlags, MatchFlags::Expand>{}, [&] {
+            return std::make_pair(surface->CanExpand(params), surface->GetInterval());
+        });
+        IsMatch_Helper(std::integral_constant<MatchFlags, MatchFlags::TexCopy>{}, [&] {
+            return std::make_pair(surface->CanTexCopy(params), surface->GetInterval());
+        });
+    };
+
+    if constexpr (find_flags == (MatchFlags::Exact | MatchFlags::Invalid)) {
+        // Only surfaces with the same parameters can match exactly
+        for (const Surface& surface : surface_index.FindExact(params)) {
+            check_surface(surface);
         }
+    } else {
+        surface_index.ForEachInInterval(params.GetInterval(), check_surface);
     }
     return match_surface;
 }
@@ -1037,12 +1053,17 @@ RasterizerCacheOpenGL::RasterizerCacheOpenGL() {
     texture_filterer =
         std::make_unique<TextureFilterer>(Settings::values.texture_filter, resolution_scale_factor);
     format_reinterpreter = std::make_unique<FormatReinterpreterOpenGL>();
+    vertex_buffer_cache = std::make_unique<VertexBufferCache>(*this);
 
     read_framebuffer.Create();
     draw_framebuffer.Create();
+
+    VideoCore::g_surface_cache_stats.evicted_surfaces = 0;
+    VideoCore::g_surface_cache_stats.evicted_memory = 0;
 }
 
 RasterizerCacheOpenGL::~RasterizerCacheOpenGL() {
+    vertex_buffer_cache->Clear();
     FlushAll();
     while (!surface_cache.empty())
         UnregisterSurface(*surface_cache.begin()->second.begin());
@@ -1076,7 +1097,7 @@ Surface RasterizerCacheOpenGL::GetSurface(const SurfaceParams& params, ScaleMatc
 
     // Check for an exact match in existing surfaces
     Surface surface =
-        FindMatch<MatchFlags::Exact | MatchFlags::Invalid>(surface_cache, params, match_res_scale);
+        FindMatch<MatchFlags::Exact | MatchFlags::Invalid>(surface_index, params, match_res_scale);
 
     if (surface == nullptr) {
         u16 target_res_scale = params.res_scale;
@@ -1085,7 +1106,7 @@ Surface RasterizerCacheOpenGL::GetSurface(const SurfaceParams& params, ScaleMatc
             // it to adjust our params
             SurfaceParams find_params = params;
             Surface expandable = FindMatch<MatchFlags::Expand | MatchFlags::Invalid>(
-                surface_cache, find_params, match_res_scale);
+                surface_index, find_params, match_res_scale);
             if (expandable != nullptr && expandable->res_scale > target_res_scale) {
                 target_res_scale = expandable->res_scale;
             }
@@ -1093,7 +1114,7 @@ Surface RasterizerCacheOpenGL::GetSurface(const SurfaceParams& params, ScaleMatc
             if (params.pixel_format == PixelFormat::RGBA8) {
                 find_params.pixel_format = PixelFormat::D24S8;
                 expandable = FindMatch<MatchFlags::Expand | MatchFlags::Invalid>(
-                    surface_cache, find_params, match_res_scale);
+                    surface_index, find_params, match_res_scale);
                 if (expandable != nullptr && expandable->res_scale > target_res_scale) {
                     target_res_scale = expandable->res_scale;
                 }
@@ -1109,6 +1130,7 @@ Surface RasterizerCacheOpenGL::GetSurface(const SurfaceParams& params, ScaleMatc
         ValidateSurface(surface, params.addr, params.size);
     }
 
+    MarkSurfaceUsed(surface);
     return surface;
 }
 
@@ -1120,7 +1142,7 @@ SurfaceRect_Tuple RasterizerCacheOpenGL::GetSurfaceSubRect(const SurfaceParams&
     }
 
     // Attempt to find encompassing surface
-    Surface surface = FindMatch<MatchFlags::SubRect | MatchFlags::Invalid>(surface_cache, params,
+    Surface surface = FindMatch<MatchFlags::SubRect | MatchFlags::Invalid>(surface_index, params,
                                                                            match_res_scale);
 
     // Check if FindMatch failed because of res scaling
@@ -1128,7 +1150,7 @@ SurfaceRect_Tuple RasterizerCacheOpenGL::GetSurfaceSubRect(const SurfaceParams&
     // the dimensions of the lower res_scale surface
     // to suggest it should not be used again
     if (surface == nullptr && match_res_scale != ScaleMatch::Ignore) {
-        surface = FindMatch<MatchFlags::SubRect | MatchFlags::Invalid>(surface_cache, params,
+        surface = FindMatch<MatchFlags::SubRect | MatchFlags::Invalid>(surface_index, params,
                                                                        ScaleMatch::Ignore);
         if (surface != nullptr) {
             SurfaceParams new_params = *surface;
@@ -1149,7 +1171,7 @@ SurfaceRect_Tuple RasterizerCacheOpenGL::GetSurfaceSubRect(const SurfaceParams&
 
     // Check for a surface we can expand before creating a new one
     if (surface == nullptr) {
-        surface = FindMatch<MatchFlags::Expand | MatchFlags::Invalid>(surface_cache, aligned_params,
+        surface = FindMatch<MatchFlags::Expand | MatchFlags::Invalid>(surface_index, aligned_params,
                                                                       match_res_scale);
         if (surface != nullptr) {
             aligned_params.width = aligned_params.stride;
@@ -1188,6 +1210,7 @@ SurfaceRect_Tuple RasterizerCacheOpenGL::GetSurfaceSubRect(const SurfaceParams&
         ValidateSurface(surface, aligned_params.addr, aligned_params.size);
     }
 
+    MarkSurfaceUsed(surface);
     return std::make_tuple(surface, surface->GetScaledSubRect(params));
 }
 
@@ -1231,6 +1254,17 @@ Surface RasterizerCacheOpenGL::GetTextureSurface(const Pica::Texture::TextureInf
     if (!surface)
         return nullptr;
 
+    // Swap in the custom texture once it was decoded in the background
+    if (surface->custom_pending &&
+        Core::System::GetInstance().CustomTexCache().IsTextureReady(surface->custom_hash)) {
+        FlushRegion(surface->addr, surface->size);
+        surface->LoadGLBuffer(surface->addr, surface->end);
+        surface->UploadGLTexture(surface->GetRect(), read_framebuffer.handle,
+                                 draw_framebuffer.handle);
+        // The texture may have been reallocated with another size, so mipmaps must be too
+        surface->max_level = 0;
+    }
+
     // Update mipmap if necessary
     if (max_level != 0) {
         if (max_level >= 8) {
@@ -1253,8 +1287,8 @@ Surface RasterizerCacheOpenGL::GetTextureSurface(const Pica::Texture::TextureInf
             u32 width;
             u32 height;
             if (surface->is_custom) {
-                width = surface->custom_tex_info.width;
-                height = surface->custom_tex_info.height;
+                width = surface->custom_width;
+                height = surface->custom_height;
             } else {
                 width = surface->GetScaledWidth();
                 height = surface->GetScaledHeight();
@@ -1293,6 +1327,10 @@ Surface RasterizerCacheOpenGL::GetTextureSurface(const Pica::Texture::TextureInf
                 }
             }
 
+            if (watcher) {
+                MarkSurfaceUsed(watcher->Get());
+            }
+
             if (watcher && !watcher->IsValid()) {
                 auto level_surface = watcher->Get();
                 if (!level_surface->invalid_regions.empty()) {
@@ -1322,6 +1360,7 @@ Surface RasterizerCacheOpenGL::GetTextureSurface(const Pica::Texture::TextureInf
         }
     }
 
+    UpdateMemoryUsage(surface);
     return surface;
 }
 
@@ -1391,6 +1430,10 @@ const CachedTextureCube& RasterizerCacheOpenGL::GetTextureCube(const TextureCube
     state.ResetTexture(cube.texture.handle);
 
     for (const Face& face : faces) {
+        if (face.watcher) {
+            MarkSurfaceUsed(face.watcher->Get());
+        }
+
         if (face.watcher && !face.watcher->IsValid()) {
             auto surface = face.watcher->Get();
             if (!surface->invalid_regions.empty()) {
@@ -1536,10 +1579,11 @@ SurfaceRect_Tuple RasterizerCacheOpenGL::GetTexCopySurface(const SurfaceParams&
     Common::Rectangle<u32> rect{};
 
     Surface match_surface = FindMatch<MatchFlags::TexCopy | MatchFlags::Invalid>(
-        surface_cache, params, ScaleMatch::Ignore);
+        surface_index, params, ScaleMatch::Ignore);
 
     if (match_surface != nullptr) {
         ValidateSurface(match_surface, params.addr, params.size);
+        MarkSurfaceUsed(match_surface);
 
         SurfaceParams match_subrect;
         if (params.width != params.stride) {
@@ -1581,6 +1625,8 @@ void RasterizerCacheOpenGL::DuplicateSurface(const Surface& src_surface,
 }
 
 void RasterizerCacheOpenGL::ValidateSurface(const Surface& surface, PAddr addr, u32 size) {
+    Common::Profiler::ScopedTimer timer{"Rasterizer Cache", "Validate Surface"};
+
     if (size == 0) {
         return;
     }
@@ -1610,7 +1656,7 @@ void RasterizerCacheOpenGL::ValidateSurface(const Surface& surface, PAddr addr,
         SurfaceParams params = surface->FromInterval(interval);
 
         Surface copy_surface =
-            FindMatch<MatchFlags::Copy>(surface_cache, params, ScaleMatch::Ignore, interval);
+            FindMatch<MatchFlags::Copy>(surface_index, params, ScaleMatch::Ignore, interval);
         if (copy_surface != nullptr) {
             SurfaceInterval copy_interval = params.GetCopyableInterval(copy_surface);
             CopySurface(copy_surface, surface, copy_interval);
@@ -1645,6 +1691,7 @@ void RasterizerCacheOpenGL::ValidateSurface(const Surface& surface, PAddr addr,
         surface->UploadGLTexture(surface->GetSubRect(params), read_framebuffer.handle,
                                  draw_framebuffer.handle);
         notify_validated(params.GetInterval());
+        UpdateMemoryUsage(surface);
     }
 }
 
@@ -1665,7 +1712,7 @@ bool RasterizerCacheOpenGL::NoUnimplementedReinterpretations(const Surface& surf
             // This could potentially be expensive,
             // although experimentally it hasn't been too bad
             Surface test_surface =
-                FindMatch<MatchFlags::Copy>(surface_cache, params, ScaleMatch::Ignore, interval);
+                FindMatch<MatchFlags::Copy>(surface_index, params, ScaleMatch::Ignore, interval);
             if (test_surface != nullptr) {
                 LOG_WARNING(Render_OpenGL, "Missing pixel_format reinterpreter: {} -> {}",
                             SurfaceParams::PixelFormatAsString(format),
@@ -1698,7 +1745,7 @@ bool RasterizerCacheOpenGL::ValidateByReinterpretation(const Surface& surface,
         PixelFormat format = reinterpreter->first.src_format;
         params.pixel_format = format;
         Surface reinterpret_surface =
-            FindMatch<MatchFlags::Copy>(surface_cache, params, ScaleMatch::Ignore, interval);
+            FindMatch<MatchFlags::Copy>(surface_index, params, ScaleMatch::Ignore, interval);
 
         if (reinterpret_surface != nullptr) {
             SurfaceInterval reinterpret_interval = params.GetCopyableInterval(reinterpret_surface);
@@ -1742,6 +1789,8 @@ bool RasterizerCacheOpenGL::ValidateByReinterpretation(const Surface& surface,
 }
 
 void RasterizerCacheOpenGL::FlushRegion(PAddr addr, u32 size, Surface flush_surface) {
+    Common::Profiler::ScopedTimer timer{"Rasterizer Cache", "Flush Region"};
+
     if (size == 0)
         return;
 
@@ -1767,6 +1816,7 @@ void RasterizerCacheOpenGL::FlushRegion(PAddr addr, u32 size, Surface flush_surf
                                        draw_framebuffer.handle);
         }
         surface->FlushGLBuffer(boost::icl::first(interval), boost::icl::last_next(interval));
+        UpdateMemoryUsage(surface);
         flushed_intervals += interval;
     }
     // Reset dirty regions
@@ -1777,44 +1827,63 @@ void RasterizerCacheOpenGL::FlushAll() {
     FlushRegion(0, 0xFFFFFFFF);
 }
 
+void RasterizerCacheOpenGL::EndFrame() {
+    const std::size_t budget =
+        static_cast<std::size_t>(Settings::values.surface_cache_memory) * 0x100000;
+    if (budget != 0 && memory_usage > budget) {
+        EvictSurfaces(budget);
+    }
+
+    // Hand finished texture dump read backs to the encoders without waiting for the pending ones
+    if (texture_dumper) {
+        texture_dumper->CollectReadbacks();
+    }
+
+    vertex_buffer_cache->EndFrame();
+    ++current_frame;
+}
+
 void RasterizerCacheOpenGL::InvalidateRegion(PAddr addr, u32 size, const Surface& region_owner) {
+    Common::Profiler::ScopedTimer timer{"Rasterizer Cache", "Invalidate Region"};
+
     if (size == 0)
         return;
 
     const SurfaceInterval invalid_interval(addr, addr + size);
 
+    vertex_buffer_cache->InvalidateRegion(addr, size);
+
     if (region_owner != nullptr) {
         ASSERT(region_owner->type != SurfaceType::Texture);
         ASSERT(addr >= region_owner->addr && addr + size <= region_owner->end);
         // Surfaces can't have a gap
         ASSERT(region_owner->width == region_owner->stride);
         region_owner->invalid_regions.erase(invalid_interval);
+        region_owner->source_hash.reset();
     }
 
-    for (const auto& pair : RangeFromInterval(surface_cache, invalid_interval)) {
-        for (const auto& cached_surface : pair.second) {
-            if (cached_surface == region_owner)
-                continue;
+    surface_index.ForEachInInterval(invalid_interval, [&](const Surface& cached_surface) {
+        if (cached_surface == region_owner)
+            return;
 
-            // If cpu is invalidating this region we want to remove it
-            // to (likely) mark the memory pages as uncached
-            if (region_owner == nullptr && size <= 8) {
-                FlushRegion(cached_surface->addr, cached_surface->size, cached_surface);
-                remove_surfaces.emplace(cached_surface);
-                continue;
-            }
+        // If cpu is invalidating this region we want to remove it
+        // to (likely) mark the memory pages as uncached
+        if (region_owner == nullptr && size <= 8) {
+            FlushRegion(cached_surface->addr, cached_surface->size, cached_surface);
+            remove_surfaces.emplace(cached_surface);
+            return;
+        }
 
-            const auto interval = cached_surface->GetInterval() & invalid_interval;
-            cached_surface->invalid_regions.insert(interval);
-            cached_surface->InvalidateAllWatcher();
+        const auto interval = cached_surface->GetInterval() & invalid_interval;
+        cached_surface->invalid_regions.insert(interval);
+        cached_surface->source_hash.reset();
+        cached_surface->InvalidateAllWatcher();
 
-            // Remove only "empty" fill surfaces to avoid destroying and recreating OGL textures
-            if (cached_surface->type == SurfaceType::Fill &&
-                cached_surface->IsSurfaceFullyInvalid()) {
-                remove_surfaces.emplace(cached_surface);
-            }
+        // Remove only "empty" fill surfaces to avoid destroying and recreating OGL textures
+        if (cached_surface->type == SurfaceType::Fill && cached_surface->IsSurfaceFullyInvalid()) {
+            remove_surfaces.emplace(cached_surface);
         }
-    }
+    });
 
     if (region_owner != nullptr)
         dirty_regions.set({invalid_interval, region_owner});
@@ -1824,7 +1893,7 @@ void RasterizerCacheOpenGL::InvalidateRegion(PAddr addr, u32 size, const Surface
     for (const auto& remove_surface : remove_surfaces) {
         if (remove_surface == region_owner) {
             Surface expanded_surface = FindMatch<MatchFlags::SubRect | MatchFlags::Invalid>(
-                surface_cache, *region_owner, ScaleMatch::Ignore);
+                surface_index, *region_owner, ScaleMatch::Ignore);
             ASSERT(expanded_surface);
 
             if ((region_owner->invalid_regions - expanded_surface->invalid_regions).empty()) {
@@ -1858,8 +1927,16 @@ void RasterizerCacheOpenGL::RegisterSurface(const Surface& surface) {
         return;
     }
     surface->registered = true;
+    surface->last_used_frame = current_frame;
+    surface->lru_position = lru_surfaces.insert(lru_surfaces.begin(), surface);
+    surface->memory_usage = surface->GetMemoryUsage();
+    memory_usage += surface->memory_usage;
     surface_cache.add({surface->GetInterval(), SurfaceSet{surface}});
+    surface_index.Add(surface);
     UpdatePagesCachedCount(surface->addr, surface->size, 1);
+
+    ++VideoCore::g_surface_cache_stats.surfaces;
+    VideoCore::g_surface_cache_stats.memory_usage = memory_usage;
 }
 
 void RasterizerCacheOpenGL::UnregisterSurface(const Surface& surface) {
@@ -1867,8 +1944,62 @@ void RasterizerCacheOpenGL::UnregisterSurface(const Surface& surface) {
         return;
     }
     surface->registered = false;
+    lru_surfaces.erase(surface->lru_position);
+    memory_usage -= surface->memory_usage;
     UpdatePagesCachedCount(surface->addr, surface->size, -1);
     surface_cache.subtract({surface->GetInterval(), SurfaceSet{surface}});
+    surface_index.Remove(surface);
+
+    --VideoCore::g_surface_cache_stats.surfaces;
+    VideoCore::g_surface_cache_stats.memory_usage = memory_usage;
+}
+
+void RasterizerCacheOpenGL::UpdateMemoryUsage(const Surface& surface) {
+    if (!surface->registered) {
+        return;
+    }
+
+    const std::size_t usage = surface->GetMemoryUsage();
+    memory_usage = memory_usage - surface->memory_usage + usage;
+    surface->memory_usage = usage;
+
+    VideoCore::g_surface_cache_stats.memory_usage = memory_usage;
+}
+
+void RasterizerCacheOpenGL::MarkSurfaceUsed(const Surface& surface) {
+    surface->last_used_frame = current_frame;
+    if (surface->registered) {
+        lru_surfaces.splice(lru_surfaces.begin(), lru_surfaces, surface->lru_position);
+    }
+}
+
+void RasterizerCacheOpenGL::EvictSurfaces(std::size_t budget) {
+    // Surfaces with dirty regions hold the only copy of that data
+    SurfaceSet dirty_surfaces;
+    for (const auto& pair : dirty_regions) {
+        dirty_surfaces.insert(pair.second);
+    }
+
+    // Walk from the least recently used surface. Surfaces used in this frame may still be
+    // referenced by the rasterizer, and every surface after the first of them was too.
+    auto it = lru_surfaces.end();
+    while (it != lru_surfaces.begin() && memory_usage > budget) {
+        const Surface surface = *std::prev(it);
+        if (surface->last_used_frame == current_frame) {
+            break;
+        }
+        if (surface->memory_usage == 0 || dirty_surfaces.count(surface) != 0) {
+            --it;
+            continue;
+        }
+
+        ++VideoCore::g_surface_cache_stats.evicted_surfaces;
+        VideoCore::g_surface_cache_stats.evicted_memory += surface->memory_usage;
+        // This erases the element before it, so it stays valid
+        UnregisterSurface(surface);
+        surface->gl_buffer.clear();
+        surface->gl_buffer.shrink_to_fit();
+    }
 }
 
 void RasterizerCacheOpenGL::UpdatePagesCachedCount(PAddr addr, u32 size, int delta) {
@@ -7,6 +7,7 @@
 #include <array>
 #include <list>
 #include <memory>
+#include <optional>
 #include <set>
 #include <tuple>
 #ifdef __GNUC__
@@ -19,6 +20,7 @@
 #pragma GCC diagnostic pop
 #endif
 #include <unordered_map>
+#include <boost/container/small_vector.hpp>
 #include <boost/container_hash/hash.hpp>
 #include <glad/glad.h>
 #include "common/assert.h"
@@ -33,7 +35,9 @@
 namespace OpenGL {
 
 class RasterizerCacheOpenGL;
+class TextureDumper;
 class TextureFilterer;
+class VertexBufferCache;
 class FormatReinterpreterOpenGL;
 
 struct TextureCubeConfig {
@@ -167,7 +171,27 @@ struct CachedSurface : SurfaceParams, std::enable_shared_from_this<CachedSurface
 
     bool is_custom = false;
     bool is_filtered = false;
-    Core::CustomTexInfo custom_tex_info;
+    /// Size of the custom texture that replaced this surface's texture
+    u32 custom_width = 0;
+    u32 custom_height = 0;
+    /// Set while the custom texture for custom_hash is decoded in the background
+    bool custom_pending = false;
+    u64 custom_hash = 0;
+    /// Custom texture found by LoadGLBuffer, released once UploadGLTexture uploaded it
+    std::shared_ptr<const Core::CustomTexInfo> custom_tex_info;
+
+    /// Hash of the surface's data in 3DS memory, reset when that memory is written
+    std::optional<u64> source_hash;
+
+    /// Frame in which this surface was last used, surfaces are evicted in that order
+    u64 last_used_frame = 0;
+    /// Host memory counted for this surface in the owner's memory usage
+    std::size_t memory_usage = 0;
+    /// Position in the owner's list of registered surfaces, valid while registered
+    std::list<Surface>::iterator lru_position;
+
+    /// Gets the host memory used by this surface's texture and gl_buffer
+    std::size_t GetMemoryUsage() const;
 
     static constexpr unsigned int GetGLBytesPerPixel(PixelFormat format) {
         // OpenGL needs 4 bpp alignment for D24 since using GL_UNSIGNED_INT as type
@@ -185,7 +209,8 @@ struct CachedSurface : SurfaceParams, std::enable_shared_from_this<CachedSurface
     void FlushGLBuffer(PAddr flush_start, PAddr flush_end);
 
     // Custom texture loading and dumping
-    bool LoadCustomTexture(u64 tex_hash);
+    u64 GetSourceHash();
+    std::shared_ptr<const Core::CustomTexInfo> LoadCustomTexture(u64 tex_hash);
     void DumpTexture(GLuint target_tex, u64 tex_hash);
 
     // Upload/Download data in gl_buffer in/to this surface's texture
@@ -224,6 +249,96 @@ private:
     u8 pbo_index{0};
 };
 
+using SurfaceBucket = boost::container::small_vector<Surface, 4>;
+
+/**
+ * Flat index of the registered surfaces. Surfaces are bucketed by the pages they overlap, and by
+ * their exact parameters since most lookups are for a surface with the same address and format.
+ */
+class SurfaceIndex {
+public:
+    void Add(const Surface& surface);
+    void Remove(const Surface& surface);
+
+    /// Gets the surfaces that have exactly the same parameters as params
+    const SurfaceBucket& FindExact(const SurfaceParams& params) const;
+
+    /// Calls func once for each surface overlapping interval
+    template <typename Func>
+    void ForEachInInterval(SurfaceInterval interval, Func&& func) const {
+        const PAddr start = boost::icl::first(interval);
+        const PAddr end = boost::icl::last_next(interval);
+        if (start >= end) {
+            return;
+        }
+
+        const u32 first_page = start >> PAGE_BITS;
+        const u32 last_page = (end - 1) >> PAGE_BITS;
+
+        // A surface is in the bucket of every page it overlaps, only visit it in the first one
+        // that is also in the interval
+        const auto visit_bucket = [&](u32 page, const SurfaceBucket& bucket) {
+            for (const Surface& surface : bucket) {
+                if (surface->addr < end && surface->end > start &&
+                    page == std::max(first_page, surface->addr >> PAGE_BITS)) {
+                    func(surface);
+                }
+            }
+        };
+
+        if (last_page - first_page >= buckets.size()) {
+            for (const auto& [page, bucket] : buckets) {
+                visit_bucket(page, bucket);
+            }
+        } else {
+            for (u32 page = first_page; page <= last_page; ++page) {
+                if (const auto it = buckets.find(page); it != buckets.end()) {
+                    visit_bucket(page, it->second);
+                }
+            }
+        }
+    }
+
+private:
+    static constexpr u32 PAGE_BITS = 12;
+
+    struct ExactKey {
+        PAddr addr;
+        u32 width;
+        u32 height;
+        u32 stride;
+        SurfaceParams::PixelFormat pixel_format;
+        bool is_tiled;
+
+        explicit ExactKey(const SurfaceParams& params)
+            : addr(params.addr), width(params.width), height(params.height),
+              stride(params.stride), pixel_format(params.pixel_format),
+              is_tiled(params.is_tiled) {}
+
+        bool operator==(const ExactKey& rhs) const {
+            return std::tie(addr, width, height, stride, pixel_format, is_tiled) ==
+                   std::tie(rhs.addr, rhs.width, rhs.height, rhs.stride, rhs.pixel_format,
+                            rhs.is_tiled);
+        }
+    };
+
+    struct ExactKeyHash {
+        std::size_t operator()(const ExactKey& key) const noexcept {
+            std::size_t hash = 0;
+            boost::hash_combine(hash, key.addr);
+            boost::hash_combine(hash, key.width);
+            boost::hash_combine(hash, key.height);
+            boost::hash_combine(hash, key.stride);
+            boost::hash_combine(hash, static_cast<u32>(key.pixel_format));
+            boost::hash_combine(hash, key.is_tiled);
+            return hash;
+        }
+    };
+
+    std::unordered_map<u32, SurfaceBucket> buckets;
+    std::unordered_map<ExactKey, SurfaceBucket, ExactKeyHash> exact_buckets;
+};
+
 struct CachedTextureCube {
     OGLTexture texture;
     u16 res_scale = 1;
@@ -236,6 +351,8 @@ struct CachedTextureCube {
 };
 
 class RasterizerCacheOpenGL : NonCopyable {
+    friend class VertexBufferCache;
+
 public:
     RasterizerCacheOpenGL();
     ~RasterizerCacheOpenGL();
@@ -283,6 +400,10 @@ public:
     /// Flush all cached resources tracked by this cache manager
     void FlushAll();
 
+    /// Evict surfaces if the cache is over its memory budget, hand finished texture dumps to the
+    /// encoders and start a new frame
+    void EndFrame();
+
 private:
     void DuplicateSurface(const Surface& src_surface, const Surface& dest_surface);
 
@@ -313,7 +434,18 @@ private:
     /// Increase/decrease the number of surface in pages touching the specified region
     void UpdatePagesCachedCount(PAddr addr, u32 size, int delta);
 
+    /// Recount the memory used by a surface after its texture was reallocated
+    void UpdateMemoryUsage(const Surface& surface);
+
+    /// Update a surface's last used frame and move it to the front of the LRU list
+    void MarkSurfaceUsed(const Surface& surface);
+
+    /// Remove clean surfaces that weren't used in this frame from the cache, least recently used
+    /// first, until the cache uses at most budget bytes
+    void EvictSurfaces(std::size_t budget);
+
     SurfaceCache surface_cache;
+    SurfaceIndex surface_index;
     PageMap cached_pages;
     SurfaceMap dirty_regions;
     SurfaceSet remove_surfaces;
@@ -325,9 +457,17 @@ private:
 
     std::unordered_map<TextureCubeConfig, CachedTextureCube> texture_cube_cache;
 
+    u64 current_frame = 0;
+    /// Registered surfaces, most recently used first
+    std::list<Surface> lru_surfaces;
+    /// Host memory used by the textures and gl_buffers of registered surfaces
+    std::size_t memory_usage = 0;
+
 public:
     std::unique_ptr<TextureFilterer> texture_filterer;
     std::unique_ptr<FormatReinterpreterOpenGL> format_reinterpreter;
+    std::unique_ptr<TextureDumper> texture_dumper;
+    std::unique_ptr<VertexBufferCache> vertex_buffer_cache;
 };
 
 struct FormatTuple {
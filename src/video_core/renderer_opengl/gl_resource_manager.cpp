@@ -130,6 +130,23 @@ void OGLBuffer::Release() {
     handle = 0;
 }
 
+void OGLSync::Create() {
+    if (handle != nullptr) {
+        return;
+    }
+
+    handle = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+void OGLSync::Release() {
+    if (handle == nullptr) {
+        return;
+    }
+
+    glDeleteSync(handle);
+    handle = nullptr;
+}
+
 void OGLVertexArray::Create() {
     if (handle != 0) {
         return;
@@ -7,6 +7,7 @@
 #include <unordered_map>
 #include <boost/container_hash/hash.hpp>
 #include <boost/variant.hpp>
+#include "common/profiler.h"
 #include "core/core.h"
 #include "video_core/renderer_opengl/gl_shader_manager.h"
 #include "video_core/video_core.h"
@@ -104,6 +105,8 @@ public:
     }
 
     void Create(const char* source, GLenum type) {
+        Common::Profiler::ScopedTimer timer{"Shaders", "Compile Shader"};
+
         if (shader_or_program.which() == 0) {
             boost::get<OGLShader>(shader_or_program).Create(source, type);
         } else {
@@ -253,6 +256,11 @@ public:
 
     ShaderTuple current;
 
+    // Shaders picked from the last configs, reused while the registers they depend on don't change
+    GLuint programmable_vs = 0;
+    bool programmable_vs_sanitize_mul = false;
+    GLuint fixed_gs = 0;
+
     ProgrammableVertexShaders programmable_vertex_shaders;
     TrivialVertexShader trivial_vertex_shader;
 
@@ -269,13 +277,19 @@ ShaderProgramManager::ShaderProgramManager(bool separable, bool enable_vendor_ha
 ShaderProgramManager::~ShaderProgramManager() = default;
 
 bool ShaderProgramManager::UseProgrammableVertexShader(const Pica::Regs& regs,
-                                                       Pica::Shader::ShaderSetup& setup) {
-    PicaVSConfig config{regs.vs, setup};
-    GLuint handle = impl->programmable_vertex_shaders.Get(config, setup);
-    if (handle == 0) {
+                                                       Pica::Shader::ShaderSetup& setup,
+                                                       bool config_dirty) {
+    // The accurate multiplication setting is part of the config too, and can change at any time
+    if (config_dirty || impl->programmable_vs_sanitize_mul !=
+                            VideoCore::g_hardware_shader_accurate_multiplication) {
+        PicaVSConfig config{regs.vs, setup};
+        impl->programmable_vs = impl->programmable_vertex_shaders.Get(config, setup);
+        impl->programmable_vs_sanitize_mul = config.state.sanitize_mul;
+    }
+    if (impl->programmable_vs == 0) {
         return false;
     }
-    impl->current.vs = handle;
+    impl->current.vs = impl->programmable_vs;
     return true;
 }
 
@@ -283,10 +297,12 @@ void ShaderProgramManager::UseTrivialVertexShader() {
     impl->current.vs = impl->trivial_vertex_shader.Get();
 }
 
-void ShaderProgramManager::UseFixedGeometryShader(const Pica::Regs& regs) {
-    PicaFixedGSConfig gs_config(regs);
-    GLuint handle = impl->fixed_geometry_shaders.Get(gs_config);
-    impl->current.gs = handle;
+void ShaderProgramManager::UseFixedGeometryShader(const Pica::Regs& regs, bool config_dirty) {
+    if (config_dirty) {
+        PicaFixedGSConfig gs_config(regs);
+        impl->fixed_gs = impl->fixed_geometry_shaders.Get(gs_config);
+    }
+    impl->current.gs = impl->fixed_gs;
 }
 
 void ShaderProgramManager::UseTrivialGeometryShader() {
@@ -318,6 +334,7 @@ void ShaderProgramManager::ApplyTo(OpenGLState& state) {
     } else {
         OGLProgram& cached_program = impl->program_cache[impl->current];
         if (cached_program.handle == 0) {
+            Common::Profiler::ScopedTimer timer{"Shaders", "Link Program"};
             cached_program.Create(false, {impl->current.vs, impl->current.gs, impl->current.fs});
             SetShaderUniformBlockBindings(cached_program.handle);
             SetShaderSamplerBindings(cached_program.handle);
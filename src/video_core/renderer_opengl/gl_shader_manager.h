@@ -102,9 +102,17 @@ public:
     explicit ShaderProgramManager(bool separable, bool enable_vendor_hacks);
     ~ShaderProgramManager();
 
-    bool UseProgrammableVertexShader(const Pica::Regs& config, Pica::Shader::ShaderSetup& setup);
+    /**
+     * Uses the vertex shader generated from the PICA vertex shader. If config_dirty is false, the
+     * shader picked by the previous call is used without rebuilding its config.
+     * @return false if the PICA vertex shader can't be translated
+     */
+    bool UseProgrammableVertexShader(const Pica::Regs& config, Pica::Shader::ShaderSetup& setup,
+                                     bool config_dirty);
     void UseTrivialVertexShader();
-    void UseFixedGeometryShader(const Pica::Regs& regs);
+
+    /// Same as UseProgrammableVertexShader, but for the geometry shader of the no-GS pipeline
+    void UseFixedGeometryShader(const Pica::Regs& regs, bool config_dirty);
     void UseTrivialGeometryShader();
     void UseFragmentShader(const Pica::Regs& config);
     void ApplyTo(OpenGLState& state);
@@ -0,0 +1,182 @@
+// Copyright 2020 vvctre project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fmt/format.h>
+#include <stb_image_write.h>
+#include "common/file_util.h"
+#include "common/logging/log.h"
+#include "common/scope_exit.h"
+#include "common/texture.h"
+#include "video_core/renderer_opengl/gl_state.h"
+#include "video_core/renderer_opengl/gl_texture_dumper.h"
+
+namespace OpenGL {
+
+/// Read backs that can be in flight before Dump waits for the oldest one
+constexpr std::size_t MaxReadbacks = 32;
+
+TextureDumper::TextureDumper(u64 program_id)
+    : dump_path{fmt::format("{}textures/{:016X}/",
+                            FileUtil::GetUserPath(FileUtil::UserPath::DumpDir), program_id)} {
+    if (!FileUtil::CreateFullPath(dump_path)) {
+        LOG_ERROR(Render, "Unable to create {}", dump_path);
+    }
+
+    // Remember what previous sessions dumped so that textures are only checked in memory
+    FileUtil::FSTEntry dump_dir;
+    std::vector<FileUtil::FSTEntry> files;
+    FileUtil::ScanDirectoryTree(dump_path, dump_dir);
+    FileUtil::GetAllFilesFromNestedEntries(dump_dir, files);
+    for (const auto& file : files) {
+        u32 width;
+        u32 height;
+        unsigned long long hash;
+        u32 format;
+        if (!file.isDirectory &&
+            std::sscanf(file.virtualName.c_str(), "tex1_%ux%u_%llX_%u.%*s", &width, &height, &hash,
+                        &format) == 4) {
+            dumped_textures.insert(hash);
+        }
+    }
+
+    read_framebuffer.Create();
+
+    const unsigned int worker_count = std::clamp(std::thread::hardware_concurrency() / 2, 1U, 4U);
+    for (unsigned int i = 0; i < worker_count; ++i) {
+        workers.emplace_back(&TextureDumper::WorkerLoop, this);
+    }
+}
+
+TextureDumper::~TextureDumper() {
+    CollectReadbacks(true);
+
+    {
+        std::lock_guard lock(job_mutex);
+        stop_workers = true;
+    }
+    job_cv.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+bool TextureDumper::IsDumped(u64 hash) const {
+    return dumped_textures.count(hash);
+}
+
+void TextureDumper::Dump(GLuint texture, u32 width, u32 height, u64 hash, u32 pixel_format) {
+    dumped_textures.insert(hash);
+
+    if (readbacks.size() >= MaxReadbacks) {
+        CollectReadbacks(true);
+    }
+
+    Readback readback;
+    readback.path = dump_path + fmt::format("tex1_{}x{}_{:016X}_{}.png", width, height, hash,
+                                            pixel_format);
+    readback.width = width;
+    readback.height = height;
+    if (free_buffers.empty()) {
+        readback.buffer.Create();
+    } else {
+        readback.buffer = std::move(free_buffers.back());
+        free_buffers.pop_back();
+    }
+
+    OpenGLState state = OpenGLState::GetCurState();
+    OpenGLState prev_state = state;
+    SCOPE_EXIT({ prev_state.Apply(); });
+    state.draw.read_framebuffer = read_framebuffer.handle;
+    state.Apply();
+
+    /*
+       The texture is read through a framebuffer instead of with glGetTexImage to work around a
+       small issue that happens if using custom textures with texture dumping at the same time.
+       Let's say there's 2 textures that are both 32x32 and one of them gets replaced with a higher
+       quality 256x256 texture. If the 256x256 texture is displayed first and the 32x32 texture
+       gets uploaded to the same underlying OpenGL texture, the 32x32 texture will appear in the
+       corner of the 256x256 texture. Reading the framebuffer conveniently only dumps the specified
+       region.
+    */
+    glFramebufferTexture2D(GL_READ_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, texture, 0);
+    glFramebufferTexture2D(GL_READ_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_TEXTURE_2D, 0, 0);
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, readback.buffer.handle);
+    glBufferData(GL_PIXEL_PACK_BUFFER, width * height * 4, nullptr, GL_STREAM_READ);
+    glReadPixels(0, 0, static_cast<GLsizei>(width), static_cast<GLsizei>(height), GL_RGBA,
+                 GL_UNSIGNED_BYTE, nullptr);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    readback.fence.Create();
+    readbacks.push_back(std::move(readback));
+}
+
+void TextureDumper::CollectReadbacks(bool wait) {
+    while (!readbacks.empty()) {
+        Readback& readback = readbacks.front();
+
+        const GLuint64 timeout = wait ? 1'000'000'000 : 0;
+        GLenum result =
+            glClientWaitSync(readback.fence.handle, GL_SYNC_FLUSH_COMMANDS_BIT, timeout);
+        while (wait && result == GL_TIMEOUT_EXPIRED) {
+            result = glClientWaitSync(readback.fence.handle, 0, timeout);
+        }
+        if (result == GL_TIMEOUT_EXPIRED) {
+            return;
+        }
+
+        Job job{std::move(readback.path), readback.width, readback.height};
+        job.pixels.resize(readback.width * readback.height * 4);
+
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, readback.buffer.handle);
+        const void* data =
+            glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, job.pixels.size(), GL_MAP_READ_BIT);
+        if (data != nullptr) {
+            std::memcpy(job.pixels.data(), data, job.pixels.size());
+            glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+        }
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+        if (data != nullptr) {
+            {
+                std::lock_guard lock(job_mutex);
+                jobs.push_back(std::move(job));
+            }
+            job_cv.notify_one();
+        } else {
+            LOG_ERROR(Render_OpenGL, "Failed to map the read back of {}", job.path);
+        }
+
+        free_buffers.push_back(std::move(readback.buffer));
+        readbacks.pop_front();
+    }
+}
+
+void TextureDumper::WorkerLoop() {
+    for (;;) {
+        Job job;
+        {
+            std::unique_lock lock(job_mutex);
+            job_cv.wait(lock, [this] { return stop_workers || !jobs.empty(); });
+            if (jobs.empty()) {
+                return;
+            }
+            job = std::move(jobs.front());
+            jobs.pop_front();
+        }
+
+        LOG_INFO(Render_OpenGL, "Dumping texture to {}", job.path);
+        Common::FlipRGBA8Texture(job.pixels, job.width, job.height);
+        if (stbi_write_png(job.path.c_str(), static_cast<int>(job.width),
+                           static_cast<int>(job.height), 4, job.pixels.data(),
+                           static_cast<int>(job.width) * 4) == 0) {
+            LOG_ERROR(Render_OpenGL, "Failed to save decoded texture");
+        }
+    }
+}
+
+} // namespace OpenGL
@@ -0,0 +1,71 @@
+// Copyright 2020 vvctre project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+#include <glad/glad.h>
+#include "common/common_types.h"
+#include "video_core/renderer_opengl/gl_resource_manager.h"
+
+namespace OpenGL {
+
+/**
+ * Dumps textures without stalling the emulation thread. Textures are read back into pixel buffer
+ * objects, and once their fence signals the pixels are handed to worker threads that flip, encode
+ * and write them as PNG files.
+ */
+class TextureDumper {
+public:
+    explicit TextureDumper(u64 program_id);
+    ~TextureDumper();
+
+    /// Returns true if a texture with this hash was dumped, in this session or a previous one
+    bool IsDumped(u64 hash) const;
+
+    /// Starts reading back the texture and queues it to be written once the read back completes
+    void Dump(GLuint texture, u32 width, u32 height, u64 hash, u32 pixel_format);
+
+    /// Hands the read backs that completed to the workers. If wait is true, waits for all of them.
+    void CollectReadbacks(bool wait = false);
+
+private:
+    struct Readback {
+        OGLBuffer buffer;
+        OGLSync fence;
+        std::string path;
+        u32 width;
+        u32 height;
+    };
+
+    struct Job {
+        std::string path;
+        u32 width;
+        u32 height;
+        std::vector<u8> pixels;
+    };
+
+    void WorkerLoop();
+
+    std::string dump_path;
+    std::unordered_set<u64> dumped_textures;
+
+    OGLFramebuffer read_framebuffer;
+    std::deque<Readback> readbacks;
+    std::vector<OGLBuffer> free_buffers;
+
+    std::mutex job_mutex;
+    std::condition_variable job_cv;
+    std::deque<Job> jobs;
+    bool stop_workers = false;
+    std::vector<std::thread> workers;
+};
+
+} // namespace OpenGL
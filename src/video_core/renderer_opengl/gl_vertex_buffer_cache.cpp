@@ -0,0 +1,146 @@
+// Copyright 2020 vvctre project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include "core/memory.h"
+#include "video_core/renderer_opengl/gl_rasterizer_cache.h"
+#include "video_core/renderer_opengl/gl_vertex_buffer_cache.h"
+#include "video_core/video_core.h"
+
+namespace OpenGL {
+
+/// Larger arrays are always streamed
+constexpr u32 MAX_ARRAY_SIZE = 1 * 1024 * 1024;
+/// Arrays aren't cached anymore once the cached arrays use this much memory
+constexpr std::size_t MAX_MEMORY_USAGE = 64 * 1024 * 1024;
+/// Arrays that were written to this many times after being cached are always streamed
+constexpr u32 MAX_INVALIDATIONS = 2;
+/// Arrays that weren't drawn for this many frames are forgotten
+constexpr u64 UNUSED_FRAMES = 600;
+
+VertexBufferCache::VertexBufferCache(RasterizerCacheOpenGL& owner) : owner{owner} {}
+
+VertexBufferCache::~VertexBufferCache() {
+    Clear();
+}
+
+GLuint VertexBufferCache::Get(PAddr addr, u32 size) {
+    if (size == 0 || size > MAX_ARRAY_SIZE) {
+        return 0;
+    }
+
+    const Key key{addr, size};
+
+    if (auto it = entries.find(key); it != entries.end()) {
+        it->second.last_used_frame = current_frame;
+        reused_bytes += size;
+        return it->second.buffer.handle;
+    }
+
+    auto [it, inserted] = candidates.try_emplace(key);
+    Candidate& candidate = it->second;
+    if (inserted) {
+        candidate.first_frame = current_frame;
+    }
+    candidate.last_frame = current_frame;
+
+    // Only arrays that are drawn again in a later frame are worth a buffer object of their own
+    if (candidate.first_frame == current_frame || candidate.invalidations >= MAX_INVALIDATIONS ||
+        memory_usage + size > MAX_MEMORY_USAGE) {
+        return 0;
+    }
+
+    const u8* data = VideoCore::g_memory->GetPhysicalPointer(addr);
+    if (data == nullptr) {
+        return 0;
+    }
+
+    Entry& entry = entries[key];
+    entry.buffer.Create();
+    entry.last_used_frame = current_frame;
+    glBindBuffer(GL_COPY_WRITE_BUFFER, entry.buffer.handle);
+    glBufferData(GL_COPY_WRITE_BUFFER, size, data, GL_STATIC_DRAW);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+    memory_usage += size;
+    uploaded_bytes += size;
+    owner.UpdatePagesCachedCount(addr, size, 1);
+
+    return entry.buffer.handle;
+}
+
+void VertexBufferCache::AddUploadedBytes(std::size_t bytes) {
+    uploaded_bytes += bytes;
+}
+
+void VertexBufferCache::InvalidateRegion(PAddr addr, u32 size) {
+    if (entries.empty()) {
+        return;
+    }
+
+    const PAddr end = addr + size;
+
+    // No array starts more than MAX_ARRAY_SIZE bytes before the region if it overlaps it
+    auto it = entries.lower_bound({addr < MAX_ARRAY_SIZE ? 0 : addr - MAX_ARRAY_SIZE, 0});
+    while (it != entries.end() && it->first.first < end) {
+        if (it->first.first + it->first.second > addr) {
+            auto [candidate, inserted] = candidates.try_emplace(it->first);
+            if (inserted) {
+                candidate->second.first_frame = current_frame;
+            }
+            ++candidate->second.invalidations;
+
+            it = Remove(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void VertexBufferCache::Clear() {
+    while (!entries.empty()) {
+        Remove(entries.begin());
+    }
+    candidates.clear();
+}
+
+void VertexBufferCache::EndFrame() {
+    VideoCore::g_vertex_buffer_cache_stats.uploaded_bytes = uploaded_bytes;
+    VideoCore::g_vertex_buffer_cache_stats.reused_bytes = reused_bytes;
+    VideoCore::g_vertex_buffer_cache_stats.buffers = entries.size();
+    VideoCore::g_vertex_buffer_cache_stats.memory_usage = memory_usage;
+    uploaded_bytes = 0;
+    reused_bytes = 0;
+
+    if (current_frame >= UNUSED_FRAMES) {
+        const u64 oldest_frame = current_frame - UNUSED_FRAMES;
+
+        for (auto it = entries.begin(); it != entries.end();) {
+            if (it->second.last_used_frame < oldest_frame) {
+                it = Remove(it);
+            } else {
+                ++it;
+            }
+        }
+
+        for (auto it = candidates.begin(); it != candidates.end();) {
+            if (it->second.last_frame < oldest_frame && entries.count(it->first) == 0) {
+                it = candidates.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    ++current_frame;
+}
+
+std::map<VertexBufferCache::Key, VertexBufferCache::Entry>::iterator VertexBufferCache::Remove(
+    std::map<Key, Entry>::iterator it) {
+    const auto& [addr, size] = it->first;
+    owner.UpdatePagesCachedCount(addr, size, -1);
+    memory_usage -= size;
+    return entries.erase(it);
+}
+
+} // namespace OpenGL
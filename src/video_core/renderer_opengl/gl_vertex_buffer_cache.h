@@ -0,0 +1,86 @@
+// Copyright 2020 vvctre project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <cstddef>
+#include <map>
+#include <unordered_map>
+#include <utility>
+#include <boost/container_hash/hash.hpp>
+#include <glad/glad.h>
+#include "common/common_types.h"
+#include "video_core/renderer_opengl/gl_resource_manager.h"
+
+namespace OpenGL {
+
+class RasterizerCacheOpenGL;
+
+/**
+ * Keeps guest vertex and index arrays that are drawn again in later frames in buffer objects, so
+ * they don't need to be copied to the stream buffers on every draw. The pages of cached arrays are
+ * marked as cached in the memory system like the pages of surfaces, so guest writes invalidate
+ * them.
+ */
+class VertexBufferCache {
+public:
+    explicit VertexBufferCache(RasterizerCacheOpenGL& owner);
+    ~VertexBufferCache();
+
+    /**
+     * Gets a buffer object holding the guest data in [addr, addr + size).
+     * @return the buffer's handle, or 0 if the data should be streamed
+     */
+    GLuint Get(PAddr addr, u32 size);
+
+    /// Counts data that was copied to a stream buffer in the upload statistics
+    void AddUploadedBytes(std::size_t bytes);
+
+    /// Remove arrays overlapping the region, they were written to
+    void InvalidateRegion(PAddr addr, u32 size);
+
+    /// Remove all arrays
+    void Clear();
+
+    /// Publish this frame's upload statistics and forget arrays that weren't drawn recently
+    void EndFrame();
+
+private:
+    using Key = std::pair<PAddr, u32>;
+
+    struct KeyHash {
+        std::size_t operator()(const Key& key) const noexcept {
+            std::size_t hash = 0;
+            boost::hash_combine(hash, key.first);
+            boost::hash_combine(hash, key.second);
+            return hash;
+        }
+    };
+
+    struct Candidate {
+        u64 first_frame = 0;
+        u64 last_frame = 0;
+        /// Number of times the array was written to after being cached
+        u32 invalidations = 0;
+    };
+
+    struct Entry {
+        OGLBuffer buffer;
+        u64 last_used_frame = 0;
+    };
+
+    std::map<Key, Entry>::iterator Remove(std::map<Key, Entry>::iterator it);
+
+    RasterizerCacheOpenGL& owner;
+
+    std::unordered_map<Key, Candidate, KeyHash> candidates;
+    std::map<Key, Entry> entries;
+    std::size_t memory_usage = 0;
+
+    u64 current_frame = 0;
+    std::size_t uploaded_bytes = 0;
+    std::size_t reused_bytes = 0;
+};
+
+} // namespace OpenGL
@@ -3,13 +3,18 @@
 // Refer to the license.txt file included.
 
 #include <algorithm>
+#include <chrono>
+#include <cmath>
 #include <cstddef>
 #include <cstdlib>
+#include <cstring>
 #include <memory>
+#include <vector>
 #include <glad/glad.h>
 #include "common/assert.h"
 #include "common/bit_field.h"
 #include "common/logging/log.h"
+#include "common/profiler.h"
 #include "core/core.h"
 #include "core/core_timing.h"
 #include "core/frontend/emu_window.h"
@@ -126,6 +131,12 @@ struct ScreenRectVertex {
     GLfloat tex_coord[2];
 };
 
+/// Nanoseconds to wait for the GPU to signal a fence before giving up
+constexpr GLuint64 FENCE_WAIT_TIMEOUT = 1'000'000'000;
+
+/// Frame dump readbacks that can be pending before waiting for the oldest one
+constexpr std::size_t MAX_FRAME_DUMP_READBACKS = 3;
+
 /**
  * Defines a 1:1 pixel ortographic projection matrix with (0,0) on the top-left
  * corner and (width, height) on the lower-bottom.
@@ -209,7 +220,11 @@ RendererOpenGL::RendererOpenGL(Frontend::EmuWindow& window) : RendererBase{windo
     RefreshRasterizerSetting();
 }
 
-RendererOpenGL::~RendererOpenGL() = default;
+RendererOpenGL::~RendererOpenGL() {
+    // Drop a pending screenshot. Completing it here could open a save dialog during shutdown.
+    VideoCore::g_renderer_screenshot_requested = false;
+    VideoCore::g_screenshot_complete_callback = nullptr;
+}
 
 /// Swap buffers (render frame)
 void RendererOpenGL::SwapBuffers() {
@@ -252,7 +267,12 @@ void RendererOpenGL::SwapBuffers() {
         }
     }
 
-    if (VideoCore::g_renderer_screenshot_requested) {
+    // Finish the screenshot started in a previous frame once the GPU wrote it
+    if (screenshot_fence.handle != nullptr) {
+        ReadScreenshot();
+    }
+
+    if (VideoCore::g_renderer_screenshot_requested && screenshot_fence.handle == nullptr) {
         // Draw this frame to the screenshot framebuffer
         screenshot_framebuffer.Create();
         GLuint old_read_fb = state.draw.read_framebuffer;
@@ -271,19 +291,40 @@ void RendererOpenGL::SwapBuffers() {
 
         DrawScreens(layout);
 
+        // Read the pixels into a pixel buffer object, so the CPU doesn't wait for the GPU here
+        screenshot_size = static_cast<std::size_t>(layout.width) * layout.height * 4;
+        screenshot_buffer.Create();
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, screenshot_buffer.handle);
+        glBufferData(GL_PIXEL_PACK_BUFFER, screenshot_size, nullptr, GL_STREAM_READ);
         glReadPixels(0, 0, layout.width, layout.height, GL_BGRA, GL_UNSIGNED_INT_8_8_8_8_REV,
-                     VideoCore::g_screenshot_bits);
+                     nullptr);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+        screenshot_fence.Create();
 
         screenshot_framebuffer.Release();
         state.draw.read_framebuffer = old_read_fb;
         state.draw.draw_framebuffer = old_draw_fb;
         state.Apply();
         glDeleteRenderbuffers(1, &renderbuffer);
+    }
+
+    Core::FrameDumper& frame_dumper = Core::System::GetInstance().frame_dumper;
+    if (frame_dumper.IsStopRequested()) {
+        // The frontend requests it from its own thread, this context has the readbacks
+        frame_dumper.Stop();
+    }
 
-        VideoCore::g_screenshot_complete_callback();
-        VideoCore::g_renderer_screenshot_requested = false;
+    if (frame_dumper.IsDumping()) {
+        DumpFrame(frame_dumper);
+    } else if (frame_dump_framebuffer.handle != 0) {
+        // FlushFrameDump already sent the frames that were being read back
+        frame_dump_readbacks.clear();
+        frame_dump_framebuffer.Release();
+        frame_dump_texture.Release();
     }
 
+    state.draw.draw_framebuffer = render_window.GetRenderFramebuffer();
+    state.Apply();
     DrawScreens(render_window.GetFramebufferLayout());
 
     Core::System::GetInstance().perf_stats->EndSystemFrame();
@@ -292,14 +333,180 @@ void RendererOpenGL::SwapBuffers() {
     render_window.PollEvents();
     render_window.SwapBuffers();
 
-    Core::System::GetInstance().frame_limiter.DoFrameLimiting(
-        Core::System::GetInstance().CoreTiming().GetGlobalTimeUs());
+    rasterizer->EndFrame();
+
+    PaceFrames();
+
+    {
+        Common::Profiler::ScopedTimer timer{"Core", "Frame Limiting"};
+        Core::System::GetInstance().frame_limiter.DoFrameLimiting(
+            Core::System::GetInstance().CoreTiming().GetGlobalTimeUs());
+    }
     Core::System::GetInstance().perf_stats->BeginSystemFrame();
 
     prev_state.Apply();
     RefreshRasterizerSetting();
 }
 
+void RendererOpenGL::ReadScreenshot() {
+    if (glClientWaitSync(screenshot_fence.handle, 0, 0) == GL_TIMEOUT_EXPIRED) {
+        return;
+    }
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, screenshot_buffer.handle);
+    if (const void* pixels =
+            glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, screenshot_size, GL_MAP_READ_BIT)) {
+        std::memcpy(VideoCore::g_screenshot_bits, pixels, screenshot_size);
+        glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+    } else {
+        LOG_ERROR(Render_OpenGL, "Failed to map the screenshot buffer");
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    screenshot_buffer.Release();
+    screenshot_fence.Release();
+
+    VideoCore::g_screenshot_complete_callback();
+    VideoCore::g_renderer_screenshot_requested = false;
+}
+
+void RendererOpenGL::DumpFrame(Core::FrameDumper& frame_dumper) {
+    const Layout::FramebufferLayout& layout = frame_dumper.GetLayout();
+    const std::size_t size = static_cast<std::size_t>(layout.width) * layout.height * 4;
+
+    GLuint old_read_fb = state.draw.read_framebuffer;
+    GLuint old_draw_fb = state.draw.draw_framebuffer;
+
+    if (frame_dump_framebuffer.handle == 0 || frame_dump_width != layout.width ||
+        frame_dump_height != layout.height) {
+        frame_dump_readbacks.clear();
+        frame_dump_framebuffer.Release();
+        frame_dump_texture.Release();
+
+        frame_dump_texture.Create();
+        state.texture_units[0].texture_2d = frame_dump_texture.handle;
+        state.Apply();
+        glActiveTexture(GL_TEXTURE0);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, layout.width, layout.height, 0, GL_RGBA,
+                     GL_UNSIGNED_BYTE, nullptr);
+        state.texture_units[0].texture_2d = 0;
+
+        frame_dump_framebuffer.Create();
+        state.draw.read_framebuffer = state.draw.draw_framebuffer = frame_dump_framebuffer.handle;
+        state.Apply();
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D,
+                               frame_dump_texture.handle, 0);
+
+        frame_dump_width = layout.width;
+        frame_dump_height = layout.height;
+    }
+
+    // Draw this frame to the frame dump framebuffer
+    state.draw.read_framebuffer = state.draw.draw_framebuffer = frame_dump_framebuffer.handle;
+    state.Apply();
+    DrawScreens(layout);
+
+    // Read it back asynchronously, it's sent to the dumper once the GPU wrote it
+    FrameDumpReadback& readback = frame_dump_readbacks.emplace_back();
+    readback.buffer.Create();
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, readback.buffer.handle);
+    glBufferData(GL_PIXEL_PACK_BUFFER, size, nullptr, GL_STREAM_READ);
+    glReadPixels(0, 0, layout.width, layout.height, GL_BGRA, GL_UNSIGNED_INT_8_8_8_8_REV,
+                 nullptr);
+    readback.fence.Create();
+
+    state.draw.read_framebuffer = old_read_fb;
+    state.draw.draw_framebuffer = old_draw_fb;
+    state.Apply();
+
+    SendFrameDumps(frame_dumper, false);
+}
+
+void RendererOpenGL::FlushFrameDump() {
+    SendFrameDumps(Core::System::GetInstance().frame_dumper, true);
+}
+
+void RendererOpenGL::SendFrameDumps(Core::FrameDumper& frame_dumper, bool wait_all) {
+    const std::size_t size = static_cast<std::size_t>(frame_dump_width) * frame_dump_height * 4;
+
+    // Frames are sent in order, so the oldest readback is waited for if there are too many
+    while (!frame_dump_readbacks.empty()) {
+        FrameDumpReadback& oldest = frame_dump_readbacks.front();
+        const bool wait = wait_all || frame_dump_readbacks.size() > MAX_FRAME_DUMP_READBACKS;
+        const GLenum result =
+            glClientWaitSync(oldest.fence.handle, wait ? GL_SYNC_FLUSH_COMMANDS_BIT : 0,
+                             wait ? FENCE_WAIT_TIMEOUT : 0);
+        if (result == GL_TIMEOUT_EXPIRED && !wait) {
+            break;
+        }
+
+        std::vector<u8> frame(size);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, oldest.buffer.handle);
+        if (const void* pixels = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, size, GL_MAP_READ_BIT)) {
+            std::memcpy(frame.data(), pixels, size);
+            glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+            frame_dumper.AddVideoFrame(std::move(frame));
+        } else {
+            LOG_ERROR(Render_OpenGL, "Failed to map a frame dump buffer");
+        }
+        frame_dump_readbacks.pop_front();
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+}
+
+void RendererOpenGL::PaceFrames() {
+    const auto now = std::chrono::steady_clock::now();
+
+    // Frame time and jitter of the last FRAME_TIME_SAMPLES frames
+    if (last_swap_time) {
+        frame_times[frame_time_index] = static_cast<u64>(
+            std::chrono::duration_cast<std::chrono::microseconds>(now - *last_swap_time).count());
+        frame_time_index = (frame_time_index + 1) % frame_times.size();
+        frame_time_count = std::min(frame_time_count + 1, frame_times.size());
+
+        double mean = 0.0;
+        for (std::size_t i = 0; i < frame_time_count; ++i) {
+            mean += frame_times[i];
+        }
+        mean /= frame_time_count;
+
+        double variance = 0.0;
+        for (std::size_t i = 0; i < frame_time_count; ++i) {
+            variance += (frame_times[i] - mean) * (frame_times[i] - mean);
+        }
+        variance /= frame_time_count;
+
+        VideoCore::g_presentation_stats.frame_time = static_cast<u64>(mean);
+        VideoCore::g_presentation_stats.frame_time_jitter = static_cast<u64>(std::sqrt(variance));
+    }
+    last_swap_time = now;
+
+    InFlightFrame& frame = frames_in_flight.emplace_back();
+    frame.fence.Create();
+    frame.submit_time = now;
+
+    // Retire the frames the GPU finished, and wait for the oldest ones if too many are in flight
+    const std::size_t limit = Settings::values.frames_in_flight;
+    while (!frames_in_flight.empty()) {
+        InFlightFrame& oldest = frames_in_flight.front();
+        const bool wait = limit != 0 && frames_in_flight.size() > limit;
+        const GLenum result =
+            glClientWaitSync(oldest.fence.handle, wait ? GL_SYNC_FLUSH_COMMANDS_BIT : 0,
+                             wait ? FENCE_WAIT_TIMEOUT : 0);
+        if (result == GL_TIMEOUT_EXPIRED && !wait) {
+            break;
+        }
+
+        VideoCore::g_presentation_stats.latency = static_cast<u64>(
+            std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() -
+                                                                  oldest.submit_time)
+                .count());
+        frames_in_flight.pop_front();
+    }
+
+    VideoCore::g_presentation_stats.frames_in_flight = frames_in_flight.size();
+}
+
 /**
  * Loads framebuffer from emulated memory into the active OpenGL texture.
  */
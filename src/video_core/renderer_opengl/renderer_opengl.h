@@ -5,6 +5,10 @@
 #pragma once
 
 #include <array>
+#include <chrono>
+#include <cstddef>
+#include <deque>
+#include <optional>
 #include <glad/glad.h>
 #include "common/common_types.h"
 #include "common/math_util.h"
@@ -13,6 +17,10 @@
 #include "video_core/renderer_opengl/gl_resource_manager.h"
 #include "video_core/renderer_opengl/gl_state.h"
 
+namespace Core {
+class FrameDumper;
+}
+
 namespace Layout {
 struct FramebufferLayout;
 }
@@ -44,6 +52,8 @@ public:
     /// Swap buffers (render frame)
     void SwapBuffers() override;
 
+    void FlushFrameDump() override;
+
 private:
     void InitOpenGLObjects();
     void ReloadSampler();
@@ -65,6 +75,32 @@ private:
     // Fills active OpenGL texture with the given RGB color.
     void LoadColorToActiveGLTexture(u8 color_r, u8 color_g, u8 color_b, const TextureInfo& texture);
 
+    /// Copies the screenshot to the requested memory if the GPU finished it
+    void ReadScreenshot();
+
+    /// Draws the frame for the frame dumper and sends it the frames the GPU finished
+    void DumpFrame(Core::FrameDumper& frame_dumper);
+
+    /**
+     * Sends the frames the GPU finished reading back to the frame dumper, in order.
+     * @param wait_all whether to wait for every frame instead of only the ones over the limit
+     */
+    void SendFrameDumps(Core::FrameDumper& frame_dumper, bool wait_all);
+
+    /// Measures the frame time and latency, and keeps the CPU at most
+    /// Settings::values.frames_in_flight frames ahead of the GPU
+    void PaceFrames();
+
+    struct FrameDumpReadback {
+        OGLBuffer buffer;
+        OGLSync fence;
+    };
+
+    struct InFlightFrame {
+        OGLSync fence;
+        std::chrono::steady_clock::time_point submit_time;
+    };
+
     OpenGLState state;
 
     // OpenGL object IDs
@@ -74,6 +110,27 @@ private:
     OGLFramebuffer screenshot_framebuffer;
     OGLSampler filter_sampler;
 
+    // Screenshot being read back
+    OGLBuffer screenshot_buffer;
+    OGLSync screenshot_fence;
+    std::size_t screenshot_size = 0;
+
+    // Frame dumping
+    OGLTexture frame_dump_texture;
+    OGLFramebuffer frame_dump_framebuffer;
+    u32 frame_dump_width = 0;
+    u32 frame_dump_height = 0;
+    std::deque<FrameDumpReadback> frame_dump_readbacks;
+
+    /// Frames submitted to the GPU that it didn't finish yet, oldest first
+    std::deque<InFlightFrame> frames_in_flight;
+
+    // Microseconds between the last swaps
+    std::array<u64, 60> frame_times{};
+    std::size_t frame_time_index = 0;
+    std::size_t frame_time_count = 0;
+    std::optional<std::chrono::steady_clock::time_point> last_swap_time;
+
     /// Display information for top and bottom screens respectively
     std::array<ScreenInfo, 3> screen_infos;
 
@@ -6,6 +6,9 @@
 #include <functional>
 #include <unordered_map>
 #include "common/logging/log.h"
+#include "common/scope_exit.h"
+#include "core/settings.h"
+#include "video_core/renderer_opengl/gl_state.h"
 #include "video_core/renderer_opengl/texture_filters/anime4k_ultrafast.h"
 #include "video_core/renderer_opengl/texture_filters/bicubic.h"
 #include "video_core/renderer_opengl/texture_filters/scale_force.h"
@@ -32,6 +35,27 @@ static const std::unordered_map<std::string_view, TextureFilterContructor> filte
     FilterMapPair<XbrzFreescale>(),
 };
 
+void CopyColor(GLuint src_tex, const Common::Rectangle<u32>& src_rect, GLuint dst_tex,
+               const Common::Rectangle<u32>& dst_rect, GLuint read_fb_handle,
+               GLuint draw_fb_handle) {
+    OpenGLState prev_state = OpenGLState::GetCurState();
+    SCOPE_EXIT({ prev_state.Apply(); });
+
+    OpenGLState state;
+    state.draw.read_framebuffer = read_fb_handle;
+    state.draw.draw_framebuffer = draw_fb_handle;
+    state.Apply();
+
+    glFramebufferTexture2D(GL_READ_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, src_tex, 0);
+    glFramebufferTexture2D(GL_READ_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_TEXTURE_2D, 0, 0);
+    glFramebufferTexture2D(GL_DRAW_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, dst_tex, 0);
+    glFramebufferTexture2D(GL_DRAW_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_TEXTURE_2D, 0, 0);
+
+    glBlitFramebuffer(src_rect.left, src_rect.bottom, src_rect.right, src_rect.top, dst_rect.left,
+                      dst_rect.bottom, dst_rect.right, dst_rect.top, GL_COLOR_BUFFER_BIT,
+                      GL_NEAREST);
+}
+
 } // namespace
 
 TextureFilterer::TextureFilterer(std::string_view filter_name, u16 scale_factor) {
@@ -51,6 +75,7 @@ bool TextureFilterer::Reset(std::string_view new_filter_name, u16 new_scale_fact
 
     filter_name = iter->first;
     filter = iter->second(new_scale_factor);
+    ClearCache();
     return true;
 }
 
@@ -61,15 +86,85 @@ bool TextureFilterer::IsNull() const {
 bool TextureFilterer::Filter(GLuint src_tex, const Common::Rectangle<u32>& src_rect, GLuint dst_tex,
                              const Common::Rectangle<u32>& dst_rect,
                              SurfaceParams::SurfaceType type, GLuint read_fb_handle,
-                             GLuint draw_fb_handle) {
+                             GLuint draw_fb_handle, u64 source_hash) {
     // depth / stencil texture filtering is not supported for now
     if (IsNull() ||
         (type != SurfaceParams::SurfaceType::Color && type != SurfaceParams::SurfaceType::Texture))
         return false;
+
+    if (source_hash != 0) {
+        const auto it = cached_results.find(source_hash);
+        if (it != cached_results.end() && it->second.width == dst_rect.GetWidth() &&
+            it->second.height == dst_rect.GetHeight()) {
+            CachedResult& result = it->second;
+            lru.splice(lru.end(), lru, result.lru_position);
+            CopyColor(result.texture.handle, {0, result.height, result.width, 0}, dst_tex,
+                      dst_rect, read_fb_handle, draw_fb_handle);
+            return true;
+        }
+    }
+
     filter->Filter(src_tex, src_rect, dst_tex, dst_rect, read_fb_handle, draw_fb_handle);
+
+    if (source_hash != 0) {
+        CacheResult(source_hash, dst_tex, dst_rect, read_fb_handle, draw_fb_handle);
+    }
     return true;
 }
 
+void TextureFilterer::CacheResult(u64 source_hash, GLuint dst_tex,
+                                  const Common::Rectangle<u32>& dst_rect, GLuint read_fb_handle,
+                                  GLuint draw_fb_handle) {
+    const std::size_t budget =
+        static_cast<std::size_t>(Settings::values.filtered_textures_memory) * 0x100000;
+    const u32 width = dst_rect.GetWidth();
+    const u32 height = dst_rect.GetHeight();
+    const std::size_t size = static_cast<std::size_t>(width) * height * 4;
+    if (size > budget) {
+        return;
+    }
+
+    if (const auto it = cached_results.find(source_hash); it != cached_results.end()) {
+        // Same source with another size
+        cache_memory_usage -= static_cast<std::size_t>(it->second.width) * it->second.height * 4;
+        lru.erase(it->second.lru_position);
+        cached_results.erase(it);
+    }
+
+    while (cache_memory_usage + size > budget) {
+        const auto it = cached_results.find(lru.front());
+        cache_memory_usage -= static_cast<std::size_t>(it->second.width) * it->second.height * 4;
+        cached_results.erase(it);
+        lru.pop_front();
+    }
+
+    CachedResult& result = cached_results[source_hash];
+    result.width = width;
+    result.height = height;
+    result.lru_position = lru.insert(lru.end(), source_hash);
+    cache_memory_usage += size;
+
+    OpenGLState cur_state = OpenGLState::GetCurState();
+    const GLuint old_tex = cur_state.texture_units[0].texture_2d;
+    result.texture.Create();
+    cur_state.texture_units[0].texture_2d = result.texture.handle;
+    cur_state.Apply();
+    glActiveTexture(GL_TEXTURE0);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0);
+    cur_state.texture_units[0].texture_2d = old_tex;
+    cur_state.Apply();
+
+    CopyColor(dst_tex, dst_rect, result.texture.handle, {0, height, width, 0}, read_fb_handle,
+              draw_fb_handle);
+}
+
+void TextureFilterer::ClearCache() {
+    cached_results.clear();
+    lru.clear();
+    cache_memory_usage = 0;
+}
+
 std::vector<std::string_view> TextureFilterer::GetFilterNames() {
     std::vector<std::string_view> ret;
     std::transform(filter_map.begin(), filter_map.end(), std::back_inserter(ret),
@@ -4,12 +4,16 @@
 
 #pragma once
 
+#include <cstddef>
+#include <list>
 #include <memory>
 #include <string_view>
+#include <unordered_map>
 #include <vector>
 #include <glad/glad.h>
 #include "common/common_types.h"
 #include "common/math_util.h"
+#include "video_core/renderer_opengl/gl_resource_manager.h"
 #include "video_core/renderer_opengl/gl_surface_params.h"
 #include "video_core/renderer_opengl/texture_filters/texture_filter_base.h"
 
@@ -27,16 +31,34 @@ public:
     // Returns true if there is no active filter
     bool IsNull() const;
 
-    // Returns true if the texture was able to be filtered
+    // Returns true if the texture was able to be filtered.
+    // If source_hash isn't 0, the result is cached and reused for sources with the same hash.
     bool Filter(GLuint src_tex, const Common::Rectangle<u32>& src_rect, GLuint dst_tex,
                 const Common::Rectangle<u32>& dst_rect, SurfaceParams::SurfaceType type,
-                GLuint read_fb_handle, GLuint draw_fb_handle);
+                GLuint read_fb_handle, GLuint draw_fb_handle, u64 source_hash = 0);
 
     static std::vector<std::string_view> GetFilterNames();
 
 private:
+    struct CachedResult {
+        OGLTexture texture;
+        u32 width;
+        u32 height;
+        std::list<u64>::iterator lru_position;
+    };
+
+    // Copies the filtered texture in dst_rect to the cache, evicting results over the budget
+    void CacheResult(u64 source_hash, GLuint dst_tex, const Common::Rectangle<u32>& dst_rect,
+                     GLuint read_fb_handle, GLuint draw_fb_handle);
+
+    void ClearCache();
+
     std::string_view filter_name = NONE;
     std::unique_ptr<TextureFilterBase> filter;
+
+    std::unordered_map<u64, CachedResult> cached_results;
+    std::list<u64> lru; // Least recently used first
+    std::size_t cache_memory_usage = 0;
 };
 
 } // namespace OpenGL
@@ -33,6 +33,10 @@ Layout::FramebufferLayout g_screenshot_framebuffer_layout;
 
 Memory::MemorySystem* g_memory;
 
+SurfaceCacheStats g_surface_cache_stats;
+VertexBufferCacheStats g_vertex_buffer_cache_stats;
+PresentationStats g_presentation_stats;
+
 /// Initialize the video core
 void Init(Frontend::EmuWindow& emu_window, Memory::MemorySystem& memory) {
     g_memory = &memory;
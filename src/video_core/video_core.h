@@ -6,6 +6,7 @@
 
 #include <atomic>
 #include <memory>
+#include "common/common_types.h"
 #include "core/frontend/emu_window.h"
 
 namespace Frontend {
@@ -41,6 +42,36 @@ extern Layout::FramebufferLayout g_screenshot_framebuffer_layout;
 
 extern Memory::MemorySystem* g_memory;
 
+/// Statistics of the hardware renderer's surface cache
+struct SurfaceCacheStats {
+    std::atomic<u64> surfaces{0};
+    std::atomic<u64> memory_usage{0}; ///< Bytes
+    std::atomic<u64> evicted_surfaces{0};
+    std::atomic<u64> evicted_memory{0}; ///< Bytes
+};
+
+extern SurfaceCacheStats g_surface_cache_stats;
+
+/// Statistics of the hardware renderer's vertex and index array uploads in the last frame
+struct VertexBufferCacheStats {
+    std::atomic<u64> uploaded_bytes{0};
+    std::atomic<u64> reused_bytes{0};
+    std::atomic<u64> buffers{0};
+    std::atomic<u64> memory_usage{0}; ///< Bytes
+};
+
+extern VertexBufferCacheStats g_vertex_buffer_cache_stats;
+
+/// Statistics of the frames presented by the renderer
+struct PresentationStats {
+    std::atomic<u64> frame_time{0};        ///< Microseconds, mean of the last 60 frames
+    std::atomic<u64> frame_time_jitter{0}; ///< Microseconds, standard deviation of the same frames
+    std::atomic<u64> latency{0};           ///< Microseconds the GPU took to finish a frame
+    std::atomic<u64> frames_in_flight{0};
+};
+
+extern PresentationStats g_presentation_stats;
+
 /// Initialize the video core
 void Init(Frontend::EmuWindow& emu_window, Memory::MemorySystem& memory);
 
@@ -3,6 +3,7 @@
 // Refer to the license.txt file included.
 
 #include <algorithm>
+#include <chrono>
 #include <cstdlib>
 #include <string>
 #define SDL_MAIN_HANDLED
@@ -25,6 +26,7 @@
 #include "audio_core/sink_details.h"
 #include "common/file_util.h"
 #include "common/logging/log.h"
+#include "common/profiler.h"
 #include "common/string_util.h"
 #include "common/texture.h"
 #include "core/3ds.h"
@@ -33,6 +35,7 @@
 #include "core/core.h"
 #include "core/hle/service/am/am.h"
 #include "core/hle/service/cfg/cfg.h"
+#include "core/hle/service/function_stats.h"
 #include "core/hle/service/nfc/nfc.h"
 #include "core/hle/service/ptm/ptm.h"
 #include "core/movie.h"
@@ -48,8 +51,12 @@
 #include "video_core/video_core.h"
 #include "vvctre/common.h"
 #include "vvctre/emu_window/emu_window_sdl2.h"
+#include "vvctre/emu_window/presenter.h"
 #include "vvctre/plugins.h"
 
+/// How long the main thread waits for a frame before drawing the menus again
+constexpr std::chrono::milliseconds FRAME_WAIT_TIMEOUT{16};
+
 static std::string IPC_Recorder_GetStatusString(IPCDebugger::RequestStatus status) {
     switch (status) {
     case IPCDebugger::RequestStatus::Sent:
@@ -148,9 +155,13 @@ void EmuWindow_SDL2::ToggleFullscreen() {
 }
 
 EmuWindow_SDL2::EmuWindow_SDL2(Core::System& system, PluginManager& plugin_manager,
-                               SDL_Window* window)
-    : window(window), system(system), plugin_manager(plugin_manager) {
+                               SDL_Window* window, void* context, Presenter& presenter)
+    : window(window), context(context), presenter(presenter), system(system),
+      plugin_manager(plugin_manager) {
     Network::Init();
+    if (Settings::values.use_local_wireless) {
+        Network::StartLocalWireless();
+    }
 
     if (std::shared_ptr<Network::RoomMember> room_member = Network::GetRoomMember().lock()) {
         multiplayer_on_error =
@@ -220,8 +231,6 @@ EmuWindow_SDL2::EmuWindow_SDL2(Core::System& system, PluginManager& plugin_manag
                           Core::kScreenTopHeight + Core::kScreenBottomHeight);
     }
 
-    SDL_GL_SetSwapInterval(Settings::values.enable_vsync ? 1 : 0);
-
     OnResize();
     SDL_PumpEvents();
     LOG_INFO(Frontend, "Version: {}.{}.{}", vvctre_version_major, vvctre_version_minor,
@@ -234,7 +243,7 @@ EmuWindow_SDL2::~EmuWindow_SDL2() {
     Network::Shutdown();
 }
 
-void EmuWindow_SDL2::SwapBuffers() {
+void EmuWindow_SDL2::DrawMenus() {
     ImGui_ImplOpenGL3_NewFrame();
     ImGui_ImplSDL2_NewFrame(window);
     ImGui::NewFrame();
@@ -247,7 +256,10 @@ void EmuWindow_SDL2::SwapBuffers() {
                          ImGuiWindowFlags_NoBackground | ImGuiWindowFlags_AlwaysAutoResize |
                          ImGuiWindowFlags_NoFocusOnAppearing)) {
         ImGui::SetWindowPos(ImVec2(), ImGuiCond_Once);
-        ImGui::TextColored(fps_color, "%d FPS", static_cast<int>(io.Framerate));
+        // The menus are drawn once per shown frame, so io.Framerate isn't the emulated FPS
+        const u64 frame_time = VideoCore::g_presentation_stats.frame_time;
+        ImGui::TextColored(fps_color, "%d FPS",
+                           frame_time != 0 ? static_cast<int>(1000000 / frame_time) : 0);
         if (ImGui::BeginPopupContextItem("##menu", ImGuiMouseButton_Right)) {
             paused = true;
 
@@ -316,11 +328,15 @@ void EmuWindow_SDL2::SwapBuffers() {
                                         ImGui::EndPopup();
                                     }
 
+                                    // The emulation context is current, and the renderer
+                                    // expects its framebuffer bindings to stay
+                                    presenter.MakeCurrent();
                                     glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
                                     glClear(GL_COLOR_BUFFER_BIT);
                                     ImGui::Render();
                                     ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
                                     SDL_GL_SwapWindow(window);
+                                    SDL_GL_MakeCurrent(window, context);
                                 });
 
                             switch (status) {
@@ -2253,6 +2269,23 @@ void EmuWindow_SDL2::SwapBuffers() {
                         }
                     }
 
+                    ImGui::Checkbox("Profiler", &show_profiler_window);
+
+                    if (ImGui::MenuItem("Dump HLE Function Statistics")) {
+                        const std::string path =
+                            pfd::save_file("Dump HLE Function Statistics", "hle.csv",
+                                           {"CSV", "*.csv"})
+                                .result();
+
+                        if (!path.empty()) {
+                            Service::DumpFunctionStats(path);
+                        }
+                    }
+
+                    if (ImGui::MenuItem("Reset HLE Function Statistics")) {
+                        Service::ResetFunctionStats();
+                    }
+
                     ImGui::EndMenu();
                 }
 
@@ -2327,6 +2360,21 @@ void EmuWindow_SDL2::SwapBuffers() {
                     CopyScreenshot();
                 }
 
+                if (system.frame_dumper.IsDumping()) {
+                    if (ImGui::MenuItem("Stop Dumping Frames")) {
+                        system.frame_dumper.RequestStop();
+                    }
+                } else if (ImGui::MenuItem("Dump Frames")) {
+                    const std::string path =
+                        pfd::save_file("Dump Frames", "frames.y4m",
+                                       {"YUV4MPEG2", "*.y4m", "Raw BGRA", "*.bgra"})
+                            .result();
+
+                    if (!path.empty()) {
+                        system.frame_dumper.Start(path, GetFramebufferLayout());
+                    }
+                }
+
                 if (ImGui::MenuItem("Dump RomFS")) {
                     const std::string folder = pfd::select_folder("Dump RomFS").result();
 
@@ -2740,6 +2788,63 @@ void EmuWindow_SDL2::SwapBuffers() {
         ImGui::End();
     }
 
+    if (show_profiler_window) {
+        ImGui::SetNextWindowSize(ImVec2(480, 640), ImGuiCond_Appearing);
+        if (ImGui::Begin("Profiler", &show_profiler_window, ImGuiWindowFlags_NoSavedSettings)) {
+            bool enabled = Common::Profiler::IsEnabled();
+            if (ImGui::Checkbox("Enabled", &enabled)) {
+                Common::Profiler::SetEnabled(enabled);
+            }
+
+            ImGui::SameLine();
+
+            if (Common::Profiler::IsTracing()) {
+                if (ImGui::Button("Save Trace")) {
+                    const std::string path =
+                        pfd::save_file("Save Trace", "trace.json", {"Chrome Trace", "*.json"})
+                            .result();
+
+                    if (!path.empty()) {
+                        Common::Profiler::StopTrace(path);
+                    }
+                }
+            } else if (ImGui::Button("Start Trace")) {
+                Common::Profiler::SetEnabled(true);
+                Common::Profiler::StartTrace();
+            }
+
+            if (ImGui::ListBoxHeader("##scopes", ImVec2(-1.0f, -1.0f))) {
+                ImGui::Columns(4);
+                ImGui::TextUnformatted("Category");
+                ImGui::NextColumn();
+                ImGui::TextUnformatted("Name");
+                ImGui::NextColumn();
+                ImGui::TextUnformatted("Time");
+                ImGui::NextColumn();
+                ImGui::TextUnformatted("Calls");
+                ImGui::NextColumn();
+                ImGui::Separator();
+
+                for (const Common::Profiler::ScopeStats& stats :
+                     Common::Profiler::GetFrameStats()) {
+                    ImGui::TextUnformatted(stats.category);
+                    ImGui::NextColumn();
+                    ImGui::TextUnformatted(stats.name);
+                    ImGui::NextColumn();
+                    ImGui::Text("%.3f ms", stats.time / 1000000.0);
+                    ImGui::NextColumn();
+                    ImGui::Text("%u", stats.calls);
+                    ImGui::NextColumn();
+                }
+
+                ImGui::Columns();
+                ImGui::ListBoxFooter();
+            }
+        }
+
+        ImGui::End();
+    }
+
     if (std::shared_ptr<Network::RoomMember> room_member = Network::GetRoomMember().lock()) {
         if (room_member->GetState() == Network::RoomMember::State::Joined) {
             ImGui::SetNextWindowSize(ImVec2(640.f, 480.0f), ImGuiCond_Appearing);
@@ -2946,13 +3051,92 @@ void EmuWindow_SDL2::SwapBuffers() {
     }
 
     ImGui::Render();
+}
+
+void EmuWindow_SDL2::SwapBuffers() {
+    presenter.SubmitFrame();
+}
+
+void EmuWindow_SDL2::PollEvents() {}
+
+void EmuWindow_SDL2::Present() {
+    LockEmulator();
+    HandleEvents();
+    DrawMenus();
+    const bool emulation_stopped = paused || emulation_waiting;
+
+    // No frames are drawn while the emulation is stopped, so VSync paces the menus then
+    const int interval = (emulation_stopped || Settings::values.enable_vsync) ? 1 : 0;
+    UnlockEmulator();
+
+    if (interval != swap_interval) {
+        SDL_GL_SetSwapInterval(interval);
+        swap_interval = interval;
+    }
+
+    if (!emulation_stopped) {
+        presenter.WaitForFrame(FRAME_WAIT_TIMEOUT);
+    }
+
+    presenter.DrawFrame();
     ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
     SDL_GL_SwapWindow(window);
 
+    LockEmulator();
     plugin_manager.AfterSwapWindow();
+    UnlockEmulator();
 }
 
-void EmuWindow_SDL2::PollEvents() {
+void EmuWindow_SDL2::BeginEmulation() {
+    emulator_mutex.lock();
+    SDL_GL_MakeCurrent(window, context);
+}
+
+void EmuWindow_SDL2::EndEmulation() {
+    SDL_GL_MakeCurrent(window, nullptr);
+    emulator_mutex.unlock();
+}
+
+void EmuWindow_SDL2::YieldEmulator() {
+    if (!main_thread_waiting) {
+        return;
+    }
+
+    // The emulation thread already has the lock. The context goes with it.
+    std::unique_lock lock{emulator_mutex, std::adopt_lock};
+    SDL_GL_MakeCurrent(window, nullptr);
+    emulator_cv.wait(lock, [this] { return !main_thread_waiting; });
+    SDL_GL_MakeCurrent(window, context);
+    lock.release();
+}
+
+void EmuWindow_SDL2::WaitForMainThread(const std::function<bool()>& done) {
+    // The emulation thread already has the lock. The context goes with it.
+    std::unique_lock lock{emulator_mutex, std::adopt_lock};
+    emulation_waiting = true;
+    SDL_GL_MakeCurrent(window, nullptr);
+    emulator_cv.wait(lock, [&] { return !is_open || done(); });
+    SDL_GL_MakeCurrent(window, context);
+    emulation_waiting = false;
+    lock.release();
+}
+
+void EmuWindow_SDL2::LockEmulator() {
+    main_thread_waiting = true;
+    emulator_mutex.lock();
+    main_thread_waiting = false;
+
+    // Menu actions and plugins reach the renderer, which only works with the emulation context
+    SDL_GL_MakeCurrent(window, context);
+}
+
+void EmuWindow_SDL2::UnlockEmulator() {
+    presenter.MakeCurrent();
+    emulator_mutex.unlock();
+    emulator_cv.notify_all();
+}
+
+void EmuWindow_SDL2::HandleEvents() {
     SDL_Event event;
 
     // SDL_PollEvent returns 0 when there are no more events in the event queue
@@ -3022,6 +3206,11 @@ void EmuWindow_SDL2::PollEvents() {
     }
 }
 
+u32 EmuWindow_SDL2::GetRenderFramebuffer() {
+    const Layout::FramebufferLayout& layout = GetFramebufferLayout();
+    return presenter.GetRenderFramebuffer(layout.width, layout.height);
+}
+
 void EmuWindow_SDL2::CopyScreenshot() {
     const auto& layout = GetFramebufferLayout();
     u8* data = new u8[layout.width * layout.height * 4];
@@ -4,9 +4,13 @@
 
 #pragma once
 
+#include <atomic>
+#include <condition_variable>
 #include <deque>
+#include <functional>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <unordered_set>
 #include <utility>
 #include <imgui.h>
@@ -18,6 +22,7 @@
 #include "vvctre/common.h"
 
 class PluginManager;
+class Presenter;
 struct SDL_Window;
 
 namespace Core {
@@ -27,15 +32,39 @@ class System;
 class EmuWindow_SDL2 : public Frontend::EmuWindow {
 public:
     explicit EmuWindow_SDL2(Core::System& system, PluginManager& plugin_manager,
-                            SDL_Window* window);
+                            SDL_Window* window, void* context, Presenter& presenter);
     ~EmuWindow_SDL2();
 
-    /// Swap buffers to display the next frame
+    /// Sends the frame to the main thread to be shown
     void SwapBuffers() override;
 
-    /// Polls window events
+    /// Does nothing, events are handled by the main thread in Present
     void PollEvents() override;
 
+    /// Gets the framebuffer of the presenter's next frame
+    u32 GetRenderFramebuffer() override;
+
+    /**
+     * Handles events, draws the menus and shows the newest frame. Called by the main thread while
+     * the emulation thread runs.
+     */
+    void Present();
+
+    /// Called by the emulation thread before it starts using the emulator
+    void BeginEmulation();
+
+    /// Called by the emulation thread after it stopped using the emulator
+    void EndEmulation();
+
+    /// Called by the emulation thread between RunLoop calls to let the main thread use the emulator
+    void YieldEmulator();
+
+    /**
+     * Lets the main thread use the emulator until done returns true or the window is closed.
+     * Called by the emulation thread.
+     */
+    void WaitForMainThread(const std::function<bool()>& done);
+
     /// Whether the window is still open, and a close request hasn't yet been sent
     bool IsOpen() const;
 
@@ -53,28 +82,43 @@ public:
     bool paused = false;
 
 private:
-    /// Called by PollEvents when a key is pressed or released.
+    /// Polls window events
+    void HandleEvents();
+
+    /// Draws the menus and the FPS
+    void DrawMenus();
+
+    /**
+     * Waits until the emulation thread lets the main thread use the emulator, and makes the
+     * emulation context current on the main thread
+     */
+    void LockEmulator();
+
+    /// Lets the emulation thread use the emulator again, and makes the presentation context current
+    void UnlockEmulator();
+
+    /// Called by HandleEvents when a key is pressed or released.
     void OnKeyEvent(int key, u8 state);
 
-    /// Called by PollEvents when the mouse moves.
+    /// Called by HandleEvents when the mouse moves.
     void OnMouseMotion(s32 x, s32 y);
 
-    /// Called by PollEvents when a mouse button is pressed or released
+    /// Called by HandleEvents when a mouse button is pressed or released
     void OnMouseButton(u32 button, u8 state, s32 x, s32 y);
 
     /// Translates pixel position (0..1) to pixel positions
     std::pair<unsigned, unsigned> TouchToPixelPos(float touch_x, float touch_y) const;
 
-    /// Called by PollEvents when a finger starts touching the touchscreen
+    /// Called by HandleEvents when a finger starts touching the touchscreen
     void OnFingerDown(float x, float y);
 
-    /// Called by PollEvents when a finger moves while touching the touchscreen
+    /// Called by HandleEvents when a finger moves while touching the touchscreen
     void OnFingerMotion(float x, float y);
 
-    /// Called by PollEvents when a finger stops touching the touchscreen
+    /// Called by HandleEvents when a finger stops touching the touchscreen
     void OnFingerUp();
 
-    /// Called by PollEvents when any event that may cause the window to be resized occurs
+    /// Called by HandleEvents when any event that may cause the window to be resized occurs
     void OnResize();
 
     /// Called when user passes the fullscreen parameter flag
@@ -86,8 +130,18 @@ private:
     void ConnectToCitraRoom();
 
     // Window
-    bool is_open = true;
+    std::atomic<bool> is_open{true};
     SDL_Window* window = nullptr;
+    void* context = nullptr; ///< SDL_GLContext the emulator runs with
+    Presenter& presenter;
+    int swap_interval = -1;
+
+    // The emulation thread has the emulator while it runs it, and lets the main thread have it
+    // between RunLoop calls and while waiting for it. Whoever has it has the emulation context.
+    std::mutex emulator_mutex;
+    std::condition_variable emulator_cv;
+    std::atomic<bool> main_thread_waiting{false};
+    bool emulation_waiting = false;
 
     // System
     Core::System& system;
@@ -108,6 +162,9 @@ private:
     // Cheats
     bool show_cheats_window = false;
 
+    // Profiler
+    bool show_profiler_window = false;
+
     // Play coins
     u16 play_coins = 0;
     bool play_coins_changed = false;
@@ -0,0 +1,167 @@
+// Copyright 2020 vvctre project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <utility>
+#include <SDL.h>
+#include "vvctre/emu_window/presenter.h"
+
+Presenter::Presenter(SDL_Window* window) : window(window) {
+    SDL_GLContext main_context = SDL_GL_GetCurrentContext();
+    SDL_GL_SetAttribute(SDL_GL_SHARE_WITH_CURRENT_CONTEXT, 1);
+    context = SDL_GL_CreateContext(window);
+    if (context != nullptr) {
+        SDL_GL_MakeCurrent(window, main_context);
+    }
+}
+
+Presenter::~Presenter() {
+    for (Frame& frame : frames) {
+        glDeleteSync(frame.render_fence);
+        glDeleteSync(frame.present_fence);
+        glDeleteFramebuffers(1, &frame.render_framebuffer);
+        glDeleteTextures(1, &frame.texture);
+    }
+
+    if (context != nullptr) {
+        SDL_GL_DeleteContext(context);
+    }
+}
+
+bool Presenter::HasContext() const {
+    return context != nullptr;
+}
+
+void Presenter::MakeCurrent() {
+    SDL_GL_MakeCurrent(window, context);
+}
+
+void Presenter::DoneCurrent() {
+    for (Frame& frame : frames) {
+        glDeleteFramebuffers(1, &frame.present_framebuffer);
+        frame.present_framebuffer = 0;
+    }
+
+    SDL_GL_MakeCurrent(window, nullptr);
+}
+
+GLuint Presenter::GetRenderFramebuffer(u32 width, u32 height) {
+    Frame& frame = frames[render_index];
+
+    if (frame.present_fence != nullptr) {
+        // Make the GPU wait until the frame isn't being shown anymore before drawing to it
+        glWaitSync(frame.present_fence, 0, GL_TIMEOUT_IGNORED);
+        glDeleteSync(frame.present_fence);
+        frame.present_fence = nullptr;
+    }
+
+    if (frame.render_fence != nullptr) {
+        // The frame was replaced by a newer one before it was shown
+        glDeleteSync(frame.render_fence);
+        frame.render_fence = nullptr;
+    }
+
+    width = std::max(width, 1U);
+    height = std::max(height, 1U);
+    if (frame.width == width && frame.height == height) {
+        return frame.render_framebuffer;
+    }
+
+    // The renderer tracks the bindings, so restore them
+    GLint texture_binding, read_framebuffer_binding, draw_framebuffer_binding;
+    glGetIntegerv(GL_TEXTURE_BINDING_2D, &texture_binding);
+    glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &read_framebuffer_binding);
+    glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &draw_framebuffer_binding);
+
+    // The texture is resized instead of recreated so the presentation context's framebuffer stays
+    // attached to it
+    if (frame.texture == 0) {
+        glGenTextures(1, &frame.texture);
+    }
+    glBindTexture(GL_TEXTURE_2D, frame.texture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE,
+                 nullptr);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+    if (frame.render_framebuffer == 0) {
+        glGenFramebuffers(1, &frame.render_framebuffer);
+        glBindFramebuffer(GL_FRAMEBUFFER, frame.render_framebuffer);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, frame.texture,
+                               0);
+    }
+
+    glBindTexture(GL_TEXTURE_2D, texture_binding);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, read_framebuffer_binding);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, draw_framebuffer_binding);
+
+    frame.width = width;
+    frame.height = height;
+    return frame.render_framebuffer;
+}
+
+void Presenter::SubmitFrame() {
+    Frame& frame = frames[render_index];
+    frame.render_fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+    // Flush so the presentation context sees the fence
+    glFlush();
+
+    {
+        std::lock_guard lock{mutex};
+        std::swap(render_index, ready_index);
+        frame_ready = true;
+    }
+    frame_ready_cv.notify_one();
+}
+
+void Presenter::WaitForFrame(std::chrono::milliseconds timeout) {
+    std::unique_lock lock{mutex};
+    frame_ready_cv.wait_for(lock, timeout, [this] { return frame_ready; });
+}
+
+void Presenter::DrawFrame() {
+    {
+        std::lock_guard lock{mutex};
+        if (frame_ready) {
+            std::swap(present_index, ready_index);
+            frame_ready = false;
+        }
+    }
+
+    Frame& frame = frames[present_index];
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+
+    if (frame.texture == 0) {
+        glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+        glClear(GL_COLOR_BUFFER_BIT);
+        return;
+    }
+
+    if (frame.render_fence != nullptr) {
+        glWaitSync(frame.render_fence, 0, GL_TIMEOUT_IGNORED);
+        glDeleteSync(frame.render_fence);
+        frame.render_fence = nullptr;
+    }
+
+    // Framebuffers aren't shared between contexts, so this context needs its own
+    if (frame.present_framebuffer == 0) {
+        glGenFramebuffers(1, &frame.present_framebuffer);
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, frame.present_framebuffer);
+        glFramebufferTexture2D(GL_READ_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D,
+                               frame.texture, 0);
+    } else {
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, frame.present_framebuffer);
+    }
+
+    int width, height;
+    SDL_GL_GetDrawableSize(window, &width, &height);
+    glBlitFramebuffer(0, 0, frame.width, frame.height, 0, 0, width, height, GL_COLOR_BUFFER_BIT,
+                      GL_LINEAR);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+
+    // The frame is drawn to again once this is signaled. The swap flushes it.
+    glDeleteSync(frame.present_fence);
+    frame.present_fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
@@ -0,0 +1,90 @@
+// Copyright 2020 vvctre project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <glad/glad.h>
+#include "common/common_types.h"
+
+struct SDL_Window;
+
+/**
+ * Hands the frames drawn by the emulation thread to the main thread, which shows them with its own
+ * OpenGL context. Frames are drawn to textures shared between the contexts. If a new frame is
+ * ready before the previous one was shown, the previous one is dropped.
+ */
+class Presenter {
+public:
+    /// Creates a context shared with the current one
+    explicit Presenter(SDL_Window* window);
+
+    /// The context that created the presenter must be current
+    ~Presenter();
+
+    /// Whether the presentation context was created
+    bool HasContext() const;
+
+    /// Makes the presentation context current on the calling thread
+    void MakeCurrent();
+
+    /// Deletes the presentation context's framebuffers and makes it not current anymore
+    void DoneCurrent();
+
+    /**
+     * Gets the framebuffer the next frame should be drawn to, resizing it if needed.
+     * Called by the emulation thread.
+     */
+    GLuint GetRenderFramebuffer(u32 width, u32 height);
+
+    /**
+     * Sends the frame drawn to the framebuffer returned by GetRenderFramebuffer to be shown.
+     * Called by the emulation thread.
+     */
+    void SubmitFrame();
+
+    /// Waits until a frame that wasn't shown yet is ready, or until the timeout passes
+    void WaitForFrame(std::chrono::milliseconds timeout);
+
+    /**
+     * Copies the newest frame to the window's framebuffer, or clears it if there's no frame yet.
+     * Called by the main thread with the presentation context current.
+     */
+    void DrawFrame();
+
+private:
+    struct Frame {
+        GLuint texture = 0;
+        u32 width = 0;
+        u32 height = 0;
+
+        /// Framebuffer of the emulation thread's context
+        GLuint render_framebuffer = 0;
+
+        /// Framebuffer of the presentation context
+        GLuint present_framebuffer = 0;
+
+        /// Signaled when drawing the frame finished
+        GLsync render_fence = nullptr;
+
+        /// Signaled when showing the frame finished
+        GLsync present_fence = nullptr;
+    };
+
+    SDL_Window* window;
+    void* context = nullptr; ///< SDL_GLContext the main thread shows the frames with
+
+    /// Frames are owned by the emulation thread, waiting to be shown, or being shown
+    std::array<Frame, 3> frames;
+    std::size_t render_index = 0;
+    std::size_t ready_index = 1;
+    std::size_t present_index = 2;
+    bool frame_ready = false;
+
+    std::mutex mutex;
+    std::condition_variable frame_ready_cv;
+};
@@ -222,6 +222,15 @@ InitialSettings::InitialSettings(PluginManager& plugin_manager, SDL_Window* wind
                                 Settings::values.record_movie = record_movie;
                             }
                         }
+
+                        if (!Settings::values.record_movie.empty()) {
+                            ImGui::Checkbox("Record State Hashes",
+                                            &Settings::values.record_movie_state_hashes);
+                            if (ImGui::IsItemHovered()) {
+                                ImGui::SetTooltip("Playback stops at the first frame where the\n"
+                                                  "memory, CPU or GPU state differs");
+                            }
+                        }
                     }
 
                     ImGui::TextUnformatted("Region:");
@@ -1670,9 +1679,24 @@ InitialSettings::InitialSettings(PluginManager& plugin_manager, SDL_Window* wind
                     }
                     ImGui::Checkbox("Use Shader JIT", &Settings::values.use_shader_jit);
                     ImGui::Checkbox("Enable VSync", &Settings::values.enable_vsync);
+                    ImGui::TextUnformatted("Frames In Flight:");
+                    ImGui::SameLine();
+                    ImGui::InputScalar("##framesinflight", ImGuiDataType_U32,
+                                       &Settings::values.frames_in_flight);
+                    if (ImGui::IsItemHovered()) {
+                        ImGui::SetTooltip("How many frames the CPU can be ahead of the GPU\n"
+                                          "More frames can increase the speed and the input lag\n"
+                                          "0 for no limit");
+                    }
                     ImGui::Checkbox("Dump Textures", &Settings::values.dump_textures);
                     ImGui::Checkbox("Use Custom Textures", &Settings::values.custom_textures);
                     ImGui::Checkbox("Preload Custom Textures", &Settings::values.preload_textures);
+                    ImGui::TextUnformatted("Custom Textures Memory:");
+                    ImGui::SameLine();
+                    ImGui::InputScalar("##customtexturesmemory", ImGuiDataType_U32,
+                                       &Settings::values.custom_textures_memory);
+                    ImGui::SameLine();
+                    ImGui::TextUnformatted("MiB");
                     ImGui::Checkbox("Enable Linear Filtering",
                                     &Settings::values.enable_linear_filtering);
                     if (ImGui::IsItemHovered()) {
@@ -1680,6 +1704,15 @@ InitialSettings::InitialSettings(PluginManager& plugin_manager, SDL_Window* wind
                     }
                     ImGui::Checkbox("Sharper Distant Objects",
                                     &Settings::values.sharper_distant_objects);
+                    ImGui::TextUnformatted("Surface Cache Memory:");
+                    ImGui::SameLine();
+                    ImGui::InputScalar("##surfacecachememory", ImGuiDataType_U32,
+                                       &Settings::values.surface_cache_memory);
+                    ImGui::SameLine();
+                    ImGui::TextUnformatted("MiB");
+                    if (ImGui::IsItemHovered()) {
+                        ImGui::SetTooltip("0 for no limit");
+                    }
 
                     ImGui::TextUnformatted("Resolution");
                     ImGui::SameLine();
@@ -1740,6 +1773,16 @@ InitialSettings::InitialSettings(PluginManager& plugin_manager, SDL_Window* wind
                         ImGui::EndCombo();
                     }
 
+                    ImGui::TextUnformatted("Filtered Textures Memory:");
+                    ImGui::SameLine();
+                    ImGui::InputScalar("##filteredtexturesmemory", ImGuiDataType_U32,
+                                       &Settings::values.filtered_textures_memory);
+                    ImGui::SameLine();
+                    ImGui::TextUnformatted("MiB");
+                    if (ImGui::IsItemHovered()) {
+                        ImGui::SetTooltip("0 to filter textures again every time they're loaded");
+                    }
+
                     ImGui::TextUnformatted("3D");
                     ImGui::SameLine();
 
@@ -2740,6 +2783,12 @@ InitialSettings::InitialSettings(PluginManager& plugin_manager, SDL_Window* wind
                     ImGui::SameLine();
                     ImGui::InputText("##password", &Settings::values.multiplayer_password);
 
+                    ImGui::Checkbox("Use Local Wireless", &Settings::values.use_local_wireless);
+                    if (ImGui::IsItemHovered()) {
+                        ImGui::SetTooltip("Connects to other vvctre instances on this computer "
+                                          "instead of to a room");
+                    }
+
                     ImGui::NewLine();
                     ImGui::TextUnformatted("Public Rooms");
 
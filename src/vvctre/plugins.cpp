@@ -24,12 +24,14 @@
 #include "core/hle/service/am/am.h"
 #include "core/hle/service/cam/cam.h"
 #include "core/hle/service/cfg/cfg.h"
+#include "core/hle/service/function_stats.h"
 #include "core/hle/service/hid/hid.h"
 #include "core/hle/service/ir/ir_user.h"
 #include "core/hle/service/nfc/nfc.h"
 #include "core/hle/service/ptm/ptm.h"
 #include "core/hle/service/sm/sm.h"
 #include "core/memory.h"
+#include "core/memory_scanner.h"
 #include "core/movie.h"
 #include "core/settings.h"
 #include "network/network.h"
@@ -363,6 +365,44 @@ void vvctre_invalidate_cache_range(void* core, u32 address, size_t length) {
     static_cast<Core::System*>(core)->CPU().InvalidateCacheRange(address, length);
 }
 
+void vvctre_read_block(void* core, VAddr address, void* buffer, size_t size) {
+    Core::System* system = static_cast<Core::System*>(core);
+    system->Memory().ReadBlock(*system->Kernel().GetCurrentProcess(), address, buffer, size);
+}
+
+void vvctre_write_block(void* core, VAddr address, const void* buffer, size_t size) {
+    Core::System* system = static_cast<Core::System*>(core);
+    system->Memory().WriteBlock(*system->Kernel().GetCurrentProcess(), address, buffer, size);
+}
+
+// Memory scans
+void* vvctre_memory_scan_new(void* core) {
+    return new Memory::MemoryScanner(*static_cast<Core::System*>(core));
+}
+
+void vvctre_memory_scan_delete(void* scan) {
+    delete static_cast<Memory::MemoryScanner*>(scan);
+}
+
+size_t vvctre_memory_scan_first(void* scan, u32 type, u32 comparison, u64 value, u64 value2) {
+    return static_cast<Memory::MemoryScanner*>(scan)->FirstScan(
+        static_cast<Memory::MemoryScanner::ValueType>(type),
+        static_cast<Memory::MemoryScanner::Comparison>(comparison), value, value2);
+}
+
+size_t vvctre_memory_scan_next(void* scan, u32 comparison, u64 value, u64 value2) {
+    return static_cast<Memory::MemoryScanner*>(scan)->NextScan(
+        static_cast<Memory::MemoryScanner::Comparison>(comparison), value, value2);
+}
+
+size_t vvctre_memory_scan_result_count(void* scan) {
+    return static_cast<Memory::MemoryScanner*>(scan)->GetResultCount();
+}
+
+size_t vvctre_memory_scan_get_results(void* scan, VAddr* addresses, size_t max) {
+    return static_cast<Memory::MemoryScanner*>(scan)->GetResults(addresses, max);
+}
+
 // Debugging
 void vvctre_set_pc(void* core, u32 addr) {
     static_cast<Core::System*>(core)->CPU().SetPC(addr);
@@ -466,6 +506,67 @@ const char* vvctre_get_service_name_by_port_id(void* core, u32 port) {
     return static_cast<Core::System*>(core)->ServiceManager().GetServiceNameByPortId(port).c_str();
 }
 
+std::size_t vvctre_hle_function_count() {
+    return Service::GetFunctionCount();
+}
+
+const char* vvctre_get_hle_function_service(std::size_t index) {
+    if (index >= Service::GetFunctionCount()) {
+        return nullptr;
+    }
+    return Service::GetFunctionStats(index).service.c_str();
+}
+
+const char* vvctre_get_hle_function_name(std::size_t index) {
+    if (index >= Service::GetFunctionCount()) {
+        return nullptr;
+    }
+    return Service::GetFunctionStats(index).name;
+}
+
+u32 vvctre_get_hle_function_header(std::size_t index) {
+    if (index >= Service::GetFunctionCount()) {
+        return 0;
+    }
+    return Service::GetFunctionStats(index).header;
+}
+
+u64 vvctre_get_hle_function_calls(std::size_t index) {
+    if (index >= Service::GetFunctionCount()) {
+        return 0;
+    }
+    return Service::GetFunctionStats(index).calls;
+}
+
+u64 vvctre_get_hle_function_host_time(std::size_t index) {
+    if (index >= Service::GetFunctionCount()) {
+        return 0;
+    }
+    return Service::GetFunctionStats(index).host_time;
+}
+
+u64 vvctre_get_hle_function_emulated_time(std::size_t index) {
+    if (index >= Service::GetFunctionCount()) {
+        return 0;
+    }
+    return Service::GetFunctionStats(index).emulated_time;
+}
+
+u64 vvctre_get_hle_function_histogram_bucket(std::size_t index, std::size_t bucket) {
+    if (index >= Service::GetFunctionCount() || bucket >= Service::FUNCTION_HISTOGRAM_BUCKETS) {
+        return 0;
+    }
+    return Service::GetFunctionStats(index).histogram[bucket];
+}
+
+void vvctre_reset_hle_function_stats() {
+    Service::ResetFunctionStats();
+}
+
+bool vvctre_dump_hle_function_stats(const char* path) {
+    return Service::DumpFunctionStats(std::string(path));
+}
+
 // Cheats
 int vvctre_cheat_count(void* core) {
     return static_cast<int>(static_cast<Core::System*>(core)->CheatEngine().GetCheats().size());
@@ -1108,6 +1209,71 @@ bool vvctre_screenshot_default_layout(void* plugin_manager, void* data) {
         layout);
 }
 
+bool vvctre_frame_dumper_start(const char* path) {
+    return Core::System::GetInstance().frame_dumper.Start(
+        std::string(path),
+        Layout::DefaultFrameLayout(Core::kScreenTopWidth,
+                                   Core::kScreenTopHeight + Core::kScreenBottomHeight, false,
+                                   false));
+}
+
+bool vvctre_frame_dumper_is_dumping() {
+    return Core::System::GetInstance().frame_dumper.IsDumping();
+}
+
+void vvctre_frame_dumper_stop() {
+    Core::System::GetInstance().frame_dumper.RequestStop();
+}
+
+// Statistics
+u64 vvctre_get_surface_cache_surfaces() {
+    return VideoCore::g_surface_cache_stats.surfaces;
+}
+
+u64 vvctre_get_surface_cache_memory_usage() {
+    return VideoCore::g_surface_cache_stats.memory_usage;
+}
+
+u64 vvctre_get_surface_cache_evicted_surfaces() {
+    return VideoCore::g_surface_cache_stats.evicted_surfaces;
+}
+
+u64 vvctre_get_surface_cache_evicted_memory() {
+    return VideoCore::g_surface_cache_stats.evicted_memory;
+}
+
+u64 vvctre_get_vertex_buffer_cache_uploaded_bytes() {
+    return VideoCore::g_vertex_buffer_cache_stats.uploaded_bytes;
+}
+
+u64 vvctre_get_vertex_buffer_cache_reused_bytes() {
+    return VideoCore::g_vertex_buffer_cache_stats.reused_bytes;
+}
+
+u64 vvctre_get_vertex_buffer_cache_buffers() {
+    return VideoCore::g_vertex_buffer_cache_stats.buffers;
+}
+
+u64 vvctre_get_vertex_buffer_cache_memory_usage() {
+    return VideoCore::g_vertex_buffer_cache_stats.memory_usage;
+}
+
+u64 vvctre_get_frame_time() {
+    return VideoCore::g_presentation_stats.frame_time;
+}
+
+u64 vvctre_get_frame_time_jitter() {
+    return VideoCore::g_presentation_stats.frame_time_jitter;
+}
+
+u64 vvctre_get_frame_latency() {
+    return VideoCore::g_presentation_stats.latency;
+}
+
+u64 vvctre_get_frames_in_flight() {
+    return VideoCore::g_presentation_stats.frames_in_flight;
+}
+
 // Settings
 void vvctre_settings_apply() {
     Settings::Apply();
@@ -1138,6 +1304,14 @@ const char* vvctre_settings_get_record_movie() {
     return Settings::values.record_movie.c_str();
 }
 
+void vvctre_settings_set_record_movie_state_hashes(bool value) {
+    Settings::values.record_movie_state_hashes = value;
+}
+
+bool vvctre_settings_get_record_movie_state_hashes() {
+    return Settings::values.record_movie_state_hashes;
+}
+
 void vvctre_settings_set_region_value(int value) {
     Settings::values.region_value = value;
 }
@@ -1469,6 +1643,14 @@ bool vvctre_settings_get_enable_vsync() {
     return Settings::values.enable_vsync;
 }
 
+void vvctre_settings_set_frames_in_flight(u32 value) {
+    Settings::values.frames_in_flight = value;
+}
+
+u32 vvctre_settings_get_frames_in_flight() {
+    return Settings::values.frames_in_flight;
+}
+
 void vvctre_settings_set_dump_textures(bool value) {
     Settings::values.dump_textures = value;
 }
@@ -1493,6 +1675,14 @@ bool vvctre_settings_get_preload_textures() {
     return Settings::values.preload_textures;
 }
 
+void vvctre_settings_set_custom_textures_memory(u32 value) {
+    Settings::values.custom_textures_memory = value;
+}
+
+u32 vvctre_settings_get_custom_textures_memory() {
+    return Settings::values.custom_textures_memory;
+}
+
 void vvctre_settings_set_enable_linear_filtering(bool value) {
     Settings::values.enable_linear_filtering = value;
 }
@@ -1509,6 +1699,22 @@ bool vvctre_settings_get_sharper_distant_objects() {
     return Settings::values.sharper_distant_objects;
 }
 
+void vvctre_settings_set_surface_cache_memory(u32 value) {
+    Settings::values.surface_cache_memory = value;
+}
+
+u32 vvctre_settings_get_surface_cache_memory() {
+    return Settings::values.surface_cache_memory;
+}
+
+void vvctre_settings_set_filtered_textures_memory(u32 value) {
+    Settings::values.filtered_textures_memory = value;
+}
+
+u32 vvctre_settings_get_filtered_textures_memory() {
+    return Settings::values.filtered_textures_memory;
+}
+
 void vvctre_settings_set_resolution(u16 value) {
     Settings::values.resolution = value;
 }
@@ -1796,6 +2002,14 @@ const char* vvctre_settings_get_multiplayer_password() {
     return Settings::values.multiplayer_password.c_str();
 }
 
+void vvctre_settings_set_use_local_wireless(bool value) {
+    Settings::values.use_local_wireless = value;
+}
+
+bool vvctre_settings_get_use_local_wireless() {
+    return Settings::values.use_local_wireless;
+}
+
 void vvctre_multiplayer_join(void* core) {
     if (std::shared_ptr<Network::RoomMember> room_member = Network::GetRoomMember().lock()) {
         room_member->Join(Settings::values.multiplayer_nickname,
@@ -2001,6 +2215,15 @@ std::unordered_map<std::string, void*> PluginManager::function_map = {
     {"vvctre_read_u64", (void*)&vvctre_read_u64},
     {"vvctre_write_u64", (void*)&vvctre_write_u64},
     {"vvctre_invalidate_cache_range", (void*)&vvctre_invalidate_cache_range},
+    {"vvctre_read_block", (void*)&vvctre_read_block},
+    {"vvctre_write_block", (void*)&vvctre_write_block},
+    // Memory scans
+    {"vvctre_memory_scan_new", (void*)&vvctre_memory_scan_new},
+    {"vvctre_memory_scan_delete", (void*)&vvctre_memory_scan_delete},
+    {"vvctre_memory_scan_first", (void*)&vvctre_memory_scan_first},
+    {"vvctre_memory_scan_next", (void*)&vvctre_memory_scan_next},
+    {"vvctre_memory_scan_result_count", (void*)&vvctre_memory_scan_result_count},
+    {"vvctre_memory_scan_get_results", (void*)&vvctre_memory_scan_get_results},
     // Debugging
     {"vvctre_set_pc", (void*)&vvctre_set_pc},
     {"vvctre_get_pc", (void*)&vvctre_get_pc},
@@ -2016,6 +2239,17 @@ std::unordered_map<std::string, void*> PluginManager::function_map = {
     {"vvctre_ipc_recorder_get_enabled", (void*)&vvctre_ipc_recorder_get_enabled},
     {"vvctre_ipc_recorder_bind_callback", (void*)&vvctre_ipc_recorder_bind_callback},
     {"vvctre_get_service_name_by_port_id", (void*)&vvctre_get_service_name_by_port_id},
+    {"vvctre_hle_function_count", (void*)&vvctre_hle_function_count},
+    {"vvctre_get_hle_function_service", (void*)&vvctre_get_hle_function_service},
+    {"vvctre_get_hle_function_name", (void*)&vvctre_get_hle_function_name},
+    {"vvctre_get_hle_function_header", (void*)&vvctre_get_hle_function_header},
+    {"vvctre_get_hle_function_calls", (void*)&vvctre_get_hle_function_calls},
+    {"vvctre_get_hle_function_host_time", (void*)&vvctre_get_hle_function_host_time},
+    {"vvctre_get_hle_function_emulated_time", (void*)&vvctre_get_hle_function_emulated_time},
+    {"vvctre_get_hle_function_histogram_bucket",
+     (void*)&vvctre_get_hle_function_histogram_bucket},
+    {"vvctre_reset_hle_function_stats", (void*)&vvctre_reset_hle_function_stats},
+    {"vvctre_dump_hle_function_stats", (void*)&vvctre_dump_hle_function_stats},
     // Cheats
     {"vvctre_cheat_count", (void*)&vvctre_cheat_count},
     {"vvctre_get_cheat", (void*)&vvctre_get_cheat},
@@ -2139,6 +2373,26 @@ std::unordered_map<std::string, void*> PluginManager::function_map = {
     {"vvctre_get_motion_state", (void*)&vvctre_get_motion_state},
     {"vvctre_screenshot", (void*)&vvctre_screenshot},
     {"vvctre_screenshot_default_layout", (void*)&vvctre_screenshot_default_layout},
+    {"vvctre_frame_dumper_start", (void*)&vvctre_frame_dumper_start},
+    {"vvctre_frame_dumper_is_dumping", (void*)&vvctre_frame_dumper_is_dumping},
+    {"vvctre_frame_dumper_stop", (void*)&vvctre_frame_dumper_stop},
+    // Statistics
+    {"vvctre_get_surface_cache_surfaces", (void*)&vvctre_get_surface_cache_surfaces},
+    {"vvctre_get_surface_cache_memory_usage", (void*)&vvctre_get_surface_cache_memory_usage},
+    {"vvctre_get_surface_cache_evicted_surfaces",
+     (void*)&vvctre_get_surface_cache_evicted_surfaces},
+    {"vvctre_get_surface_cache_evicted_memory", (void*)&vvctre_get_surface_cache_evicted_memory},
+    {"vvctre_get_vertex_buffer_cache_uploaded_bytes",
+     (void*)&vvctre_get_vertex_buffer_cache_uploaded_bytes},
+    {"vvctre_get_vertex_buffer_cache_reused_bytes",
+     (void*)&vvctre_get_vertex_buffer_cache_reused_bytes},
+    {"vvctre_get_vertex_buffer_cache_buffers", (void*)&vvctre_get_vertex_buffer_cache_buffers},
+    {"vvctre_get_vertex_buffer_cache_memory_usage",
+     (void*)&vvctre_get_vertex_buffer_cache_memory_usage},
+    {"vvctre_get_frame_time", (void*)&vvctre_get_frame_time},
+    {"vvctre_get_frame_time_jitter", (void*)&vvctre_get_frame_time_jitter},
+    {"vvctre_get_frame_latency", (void*)&vvctre_get_frame_latency},
+    {"vvctre_get_frames_in_flight", (void*)&vvctre_get_frames_in_flight},
     // Settings
     {"vvctre_settings_apply", (void*)&vvctre_settings_apply},
     // Start Settings
@@ -2148,6 +2402,10 @@ std::unordered_map<std::string, void*> PluginManager::function_map = {
     {"vvctre_settings_get_play_movie", (void*)&vvctre_settings_get_play_movie},
     {"vvctre_settings_set_record_movie", (void*)&vvctre_settings_set_record_movie},
     {"vvctre_settings_get_record_movie", (void*)&vvctre_settings_get_record_movie},
+    {"vvctre_settings_set_record_movie_state_hashes",
+     (void*)&vvctre_settings_set_record_movie_state_hashes},
+    {"vvctre_settings_get_record_movie_state_hashes",
+     (void*)&vvctre_settings_get_record_movie_state_hashes},
     {"vvctre_settings_set_region_value", (void*)&vvctre_settings_set_region_value},
     {"vvctre_settings_get_region_value", (void*)&vvctre_settings_get_region_value},
     {"vvctre_settings_set_log_filter", (void*)&vvctre_settings_set_log_filter},
@@ -2242,12 +2500,18 @@ std::unordered_map<std::string, void*> PluginManager::function_map = {
     {"vvctre_settings_get_use_shader_jit", (void*)&vvctre_settings_get_use_shader_jit},
     {"vvctre_settings_set_enable_vsync", (void*)&vvctre_settings_set_enable_vsync},
     {"vvctre_settings_get_enable_vsync", (void*)&vvctre_settings_get_enable_vsync},
+    {"vvctre_settings_set_frames_in_flight", (void*)&vvctre_settings_set_frames_in_flight},
+    {"vvctre_settings_get_frames_in_flight", (void*)&vvctre_settings_get_frames_in_flight},
     {"vvctre_settings_set_dump_textures", (void*)&vvctre_settings_set_dump_textures},
     {"vvctre_settings_get_dump_textures", (void*)&vvctre_settings_get_dump_textures},
     {"vvctre_settings_set_custom_textures", (void*)&vvctre_settings_set_custom_textures},
     {"vvctre_settings_get_custom_textures", (void*)&vvctre_settings_get_custom_textures},
     {"vvctre_settings_set_preload_textures", (void*)&vvctre_settings_set_preload_textures},
     {"vvctre_settings_get_preload_textures", (void*)&vvctre_settings_get_preload_textures},
+    {"vvctre_settings_set_custom_textures_memory",
+     (void*)&vvctre_settings_set_custom_textures_memory},
+    {"vvctre_settings_get_custom_textures_memory",
+     (void*)&vvctre_settings_get_custom_textures_memory},
     {"vvctre_settings_set_enable_linear_filtering",
      (void*)&vvctre_settings_set_enable_linear_filtering},
     {"vvctre_settings_get_enable_linear_filtering",
@@ -2256,6 +2520,12 @@ std::unordered_map<std::string, void*> PluginManager::function_map = {
      (void*)&vvctre_settings_set_sharper_distant_objects},
     {"vvctre_settings_get_sharper_distant_objects",
      (void*)&vvctre_settings_get_sharper_distant_objects},
+    {"vvctre_settings_set_surface_cache_memory", (void*)&vvctre_settings_set_surface_cache_memory},
+    {"vvctre_settings_get_surface_cache_memory", (void*)&vvctre_settings_get_surface_cache_memory},
+    {"vvctre_settings_set_filtered_textures_memory",
+     (void*)&vvctre_settings_set_filtered_textures_memory},
+    {"vvctre_settings_get_filtered_textures_memory",
+     (void*)&vvctre_settings_get_filtered_textures_memory},
     {"vvctre_settings_set_resolution", (void*)&vvctre_settings_set_resolution},
     {"vvctre_settings_get_resolution", (void*)&vvctre_settings_get_resolution},
     {"vvctre_settings_set_background_color_red", (void*)&vvctre_settings_set_background_color_red},
@@ -2356,6 +2626,8 @@ std::unordered_map<std::string, void*> PluginManager::function_map = {
     {"vvctre_settings_get_nickname", (void*)&vvctre_settings_get_nickname},
     {"vvctre_settings_set_multiplayer_password", (void*)&vvctre_settings_set_multiplayer_password},
     {"vvctre_settings_get_multiplayer_password", (void*)&vvctre_settings_get_multiplayer_password},
+    {"vvctre_settings_set_use_local_wireless", (void*)&vvctre_settings_set_use_local_wireless},
+    {"vvctre_settings_get_use_local_wireless", (void*)&vvctre_settings_get_use_local_wireless},
     {"vvctre_multiplayer_join", (void*)&vvctre_multiplayer_join},
     {"vvctre_multiplayer_leave", (void*)&vvctre_multiplayer_leave},
     {"vvctre_multiplayer_get_state", (void*)&vvctre_multiplayer_get_state},
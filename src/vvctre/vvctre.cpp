@@ -5,6 +5,7 @@
 #include <iostream>
 #include <memory>
 #include <string>
+#include <thread>
 
 #ifdef _WIN32
 // windows.h needs to be included before shellapi.h
@@ -44,6 +45,7 @@
 #include "vvctre/camera/image.h"
 #include "vvctre/common.h"
 #include "vvctre/emu_window/emu_window_sdl2.h"
+#include "vvctre/emu_window/presenter.h"
 #include "vvctre/initial_settings.h"
 #include "vvctre/plugins.h"
 
@@ -195,8 +197,16 @@ int main(int argc, char** argv) {
         Core::Movie::GetInstance().PrepareForPlayback(Settings::values.play_movie);
     }
 
+    std::unique_ptr<Presenter> presenter = std::make_unique<Presenter>(window);
+    if (!presenter->HasContext()) {
+        pfd::message("vvctre",
+                     fmt::format("Failed to create the presentation context: {}", SDL_GetError()),
+                     pfd::choice::ok, pfd::icon::error);
+        return -1;
+    }
+
     std::unique_ptr<EmuWindow_SDL2> emu_window =
-        std::make_unique<EmuWindow_SDL2>(system, plugin_manager, window);
+        std::make_unique<EmuWindow_SDL2>(system, plugin_manager, window, context, *presenter);
 
     // Register frontend applets
     system.RegisterSoftwareKeyboard(std::make_shared<Frontend::SDL2_SoftwareKeyboard>(*emu_window));
@@ -245,39 +255,56 @@ int main(int argc, char** argv) {
         Core::Movie::GetInstance().StartRecording(Settings::values.record_movie);
     }
 
-    while (emu_window->IsOpen()) {
-        if (emu_window->paused) {
-            while (emu_window->IsOpen() && emu_window->paused) {
-                VideoCore::g_renderer->SwapBuffers();
-                SDL_GL_SetSwapInterval(1);
+    // The emulator runs on its own thread, and the main thread handles events, draws the menus and
+    // shows the frames
+    SDL_GL_MakeCurrent(window, nullptr);
+    std::thread emulation_thread([&] {
+        emu_window->BeginEmulation();
+
+        while (emu_window->IsOpen()) {
+            if (emu_window->paused) {
+                emu_window->WaitForMainThread([&] { return !emu_window->paused; });
+                continue;
             }
-            SDL_GL_SetSwapInterval(Settings::values.enable_vsync ? 1 : 0);
-        }
 
-        switch (system.RunLoop()) {
-        case Core::System::ResultStatus::Success: {
-            break;
-        }
-        case Core::System::ResultStatus::FatalError: {
-            pfd::message("vvctre", "Fatal error.\nCheck the console window for more details.",
-                         pfd::choice::ok, pfd::icon::error);
-            plugin_manager.FatalError();
-            system.SetStatus(Core::System::ResultStatus::Success);
-            break;
-        }
-        case Core::System::ResultStatus::ShutdownRequested: {
-            emu_window->Close();
-            break;
-        }
-        default: {
-            break;
-        }
+            switch (system.RunLoop()) {
+            case Core::System::ResultStatus::Success: {
+                break;
+            }
+            case Core::System::ResultStatus::FatalError: {
+                pfd::message("vvctre", "Fatal error.\nCheck the console window for more details.",
+                             pfd::choice::ok, pfd::icon::error);
+                plugin_manager.FatalError();
+                system.SetStatus(Core::System::ResultStatus::Success);
+                break;
+            }
+            case Core::System::ResultStatus::ShutdownRequested: {
+                emu_window->Close();
+                break;
+            }
+            default: {
+                break;
+            }
+            }
+
+            emu_window->YieldEmulator();
         }
+
+        emu_window->EndEmulation();
+    });
+
+    presenter->MakeCurrent();
+    while (emu_window->IsOpen()) {
+        emu_window->Present();
     }
+    emulation_thread.join();
+    presenter->DoneCurrent();
+    SDL_GL_MakeCurrent(window, context);
 
     Core::Movie::GetInstance().Shutdown();
     system.Shutdown();
     plugin_manager.EmulatorClosing();
+    presenter.reset();
     SDL_GL_MakeCurrent(window, nullptr);
     InputCommon::Shutdown();
     ImGui_ImplOpenGL3_Shutdown();